@@ -0,0 +1,189 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// Repeatable microbenchmarks of the core Buffer/Module/Daq machinery, using only
+// software backends (SimDaq and the Modules below) so that numbers are comparable
+// across machines and releases. Each benchmark is run in several repeats of many
+// iterations; the minimum and median time per call are reported and written as JSON.
+//
+// usage: daq_bench [iterations] [results.json]
+
+/// An AI whose reads dispatch through util::Event (connect_read), as most backends did
+class EventAI : public AIModule {
+public:
+    EventAI(Daq& d, const ChanNums& allowed, const std::string& name) : AIModule(d, allowed) {
+        set_name(d.name() + "." + name);
+        connect_read(*this, [](const ChanNum* chs, Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = 0.001 * chs[i];
+            return true;
+        });
+    }
+};
+
+/// A Daq with a configurable number of 8 channel EventAI Modules
+class MultiDaq : public Daq {
+public:
+    MultiDaq(std::size_t modules) : Daq("multi_daq") {
+        for (std::size_t i = 0; i < modules; ++i) {
+            AIs.emplace_back(new EventAI(*this, {0, 1, 2, 3, 4, 5, 6, 7}, "AI" + std::to_string(i)));
+            AIs.back()->set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        }
+    }
+    std::vector<std::unique_ptr<EventAI>> AIs;
+};
+
+/// The timing of one benchmark
+struct Result {
+    std::string name;       ///< benchmark name
+    double      min_ns;     ///< fastest repeat, per call
+    double      median_ns;  ///< median repeat, per call
+};
+
+/// Runs func for repeats x iterations calls and returns the per call min/median in ns
+template <typename F>
+Result run(const std::string& name, F func, int iterations, int repeats) {
+    iterations = std::max(iterations, 1);  // derived counts (e.g. iterations / 100) may round to 0
+    for (int i = 0; i < iterations / 10; ++i)  // warm up
+        func();
+    std::vector<double> times(repeats);
+    for (int r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i)
+            func();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        times[r] = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+    }
+    std::sort(times.begin(), times.end());
+    Result result = {name, times.front(), times[times.size() / 2]};
+    print("{:<36} {:>10.2f} {:>10.2f}", result.name, result.min_ns, result.median_ns);
+    return result;
+}
+
+/// Writes results as JSON
+bool write_json(const std::string& filename, const std::vector<Result>& results, int iterations, int repeats) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file)
+        return false;
+    std::fprintf(file, "{\n  \"suite\": \"daq_bench\",\n");
+    std::fprintf(file, "  \"iterations\": %d,\n  \"repeats\": %d,\n", iterations, repeats);
+#ifdef MAHI_DAQ_METRICS
+    std::fprintf(file, "  \"metrics\": true,\n");
+#else
+    std::fprintf(file, "  \"metrics\": false,\n");
+#endif
+    std::fprintf(file, "  \"unit\": \"ns/call\",\n  \"results\": [\n");
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        std::fprintf(file, "    {\"name\": \"%s\", \"min\": %.3f, \"median\": %.3f}%s\n",
+                     results[i].name.c_str(), results[i].min_ns, results[i].median_ns,
+                     i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    return std::fclose(file) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (MahiLogger)
+        MahiLogger->set_max_severity(Warning);
+
+    int iterations = 1000000;
+    if (argc > 1)
+        iterations = std::atoi(argv[1]);
+    if (iterations < 1) {
+        print("usage: daq_bench [iterations >= 1] [results.json]");
+        return 1;
+    }
+    std::string filename = argc > 2 ? argv[2] : "daq_bench.json";
+    const int   repeats  = 7;
+
+    SimDaq sim;
+    sim.enable();
+    MultiDaq one(1), four(4), sixteen(16);
+    std::vector<Result> results;
+    volatile double sink = 0;
+
+    print("{:<36} {:>10} {:>10}", "[ns/call]", "min", "median");
+
+    // software buffer access, 8 channels per call
+    results.push_back(run("ISet::operator[] x8", [&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sim.AO[ch] = ch;
+    }, iterations, repeats));
+    results.push_back(run("IGet::operator[] x8", [&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sink = sink + sim.AI[ch];
+    }, iterations, repeats));
+    results.push_back(run("IGet::get(ch) x8", [&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sink = sink + sim.AI.get(ch);
+    }, iterations, repeats));
+
+    // immediate reads/writes
+    results.push_back(run("IRead::read (util::Event)", [&]() { one.AIs[0]->read(); }, iterations, repeats));
+    results.push_back(run("IRead::read (bound)", [&]() { sim.AI.read(); }, iterations, repeats));
+    results.push_back(run("IRead::read(ch) (bound)", [&]() { sim.AI.read(3); }, iterations, repeats));
+    results.push_back(run("IWrite::write (bound)", [&]() { sim.AO.write(); }, iterations, repeats));
+
+    // whole DAQ cycles
+    results.push_back(run("Daq::read_all (1 module)", [&]() { one.read_all(); }, iterations, repeats));
+    results.push_back(run("Daq::read_all (4 modules)", [&]() { four.read_all(); }, iterations, repeats));
+    results.push_back(run("Daq::read_all (16 modules)", [&]() { sixteen.read_all(); }, iterations / 4, repeats));
+    results.push_back(run("SimDaq::read_all", [&]() { sim.read_all(); }, iterations, repeats));
+    results.push_back(run("SimDaq::write_all", [&]() { sim.write_all(); }, iterations, repeats));
+
+    // remapping (a setup path, so far fewer iterations)
+    bool half = false;
+    results.push_back(run("ChanneledModule::set_channels", [&]() {
+        half = !half;
+        if (half)
+            sim.DI.set_channels({0, 2, 4, 6});
+        else
+            sim.DI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    }, iterations / 100, repeats));
+
+    // Handles
+    AIHandle      ai(sim.AI, 3);
+    AOHandle      ao(sim.AO, 3);
+    DOHandle      dout(sim.DO, 3);
+    EncoderHandle enc(sim.encoder, 3);
+    results.push_back(run("AIHandle::get_volts", [&]() { sink = sink + ai.get_volts(); }, iterations, repeats));
+    results.push_back(run("AIHandle::read_volts", [&]() { sink = sink + ai.read_volts(); }, iterations, repeats));
+    results.push_back(run("AOHandle::set_volts", [&]() { ao.set_volts(1.0); }, iterations, repeats));
+    results.push_back(run("AOHandle::write_volts", [&]() { ao.write_volts(1.0); }, iterations, repeats));
+    results.push_back(run("DOHandle::flip", [&]() { dout.flip(); }, iterations, repeats));
+    results.push_back(run("EncoderHandle::get_pos", [&]() { sink = sink + enc.get_pos(); }, iterations, repeats));
+    results.push_back(run("EncoderHandle::read_counts", [&]() { sink = sink + enc.read_counts(); }, iterations, repeats));
+
+    if (!write_json(filename, results, iterations, repeats)) {
+        print("Failed to write {}", filename);
+        return 1;
+    }
+    print("Results written to {}", filename);
+    return 0;
+}
@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example checks that a steady-state control loop makes zero heap allocations.
+// It replaces the global operator new with one that counts allocations while armed,
+// then cycles a software-only DAQ (see ex_custom.cpp) through read_all, buffer access,
+// immediate writes and write_all. It exits non-zero if anything allocated.
+
+namespace {
+std::atomic<bool> g_armed(false);     // count allocations only while true
+std::atomic<long> g_allocations(0);   // number of allocations made while armed
+}  // namespace
+
+// GCC flags free() on memory from operator new once these replacements are inlined
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    if (g_armed)
+        g_allocations++;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+/// A simulated AI whose channels read their channel number in mV
+class AllocAI : public AIModule {
+public:
+    AllocAI(Daq& d, const ChanNums& allowed) : AIModule(d, allowed), ranges(*this, {-10, 10}) {
+        set_name(d.name() + ".AI");
+        connect_read(*this, [](const ChanNum* chs, Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = 0.001 * chs[i];
+            return true;
+        });
+        // mirrors QuanserAI, which converts ranges into separate min/max arrays
+        Scratch<Volts> mins(allowed.size()), maxs(allowed.size());
+        connect_write(ranges, [mins, maxs](const ChanNum*, const Range<Volts>* vals, std::size_t n) mutable {
+            Volts* min_vals = mins.get(n);
+            Volts* max_vals = maxs.get(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                min_vals[i] = vals[i].min_val;
+                max_vals[i] = vals[i].max_val;
+            }
+            return true;
+        });
+    }
+    Register<Range<Volts>> ranges;
+};
+
+/// A simulated AO that accepts every write
+class AllocAO : public AOModule {
+public:
+    AllocAO(Daq& d, const ChanNums& allowed) : AOModule(d, allowed) {
+        set_name(d.name() + ".AO");
+        connect_write(*this, [](const ChanNum*, const Volts*, std::size_t) { return true; });
+    }
+};
+
+/// A simulated DO that accepts every write
+class AllocDO : public DOModule {
+public:
+    AllocDO(Daq& d, const ChanNums& allowed) : DOModule(d, allowed) {
+        set_name(d.name() + ".DO");
+        connect_write(*this, [](const ChanNum*, const TTL*, std::size_t) { return true; });
+    }
+};
+
+/// A simulated encoder whose counts advance by their channel number every read
+class AllocEncoder : public EncoderModule {
+public:
+    AllocEncoder(Daq& d, const ChanNums& allowed) : EncoderModule(d, allowed) {
+        set_name(d.name() + ".encoder");
+        connect_read(*this, [](const ChanNum* chs, Counts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] += static_cast<Counts>(chs[i]);
+            return true;
+        });
+        connect_write(*this, [](const ChanNum*, const Counts*, std::size_t) { return true; });
+        connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+    }
+};
+
+class AllocDaq : public Daq {
+public:
+    AllocDaq() :
+        Daq("alloc_daq"),
+        AI(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        AO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        DO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        encoder(*this, {0, 1, 2, 3, 4, 5, 6, 7}) {
+        AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        AO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        DO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        encoder.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    }
+    AllocAI      AI;
+    AllocAO      AO;
+    AllocDO      DO;
+    AllocEncoder encoder;
+};
+
+int main(int argc, char* argv[]) {
+    int cycles = 100000;
+    if (argc > 1)
+        cycles = std::atoi(argv[1]);
+
+    AllocDaq daq;
+    daq.encoder.enable_snapshots();
+    daq.open();
+    daq.enable();
+
+    const ChanNums      chs       = {1, 3, 5};
+    const Volts         volts[8]  = {0, 1, 2, 3, 4, 5, 6, 7};
+    const Range<Volts>  ranges[8] = {{-5, 5}, {-5, 5}, {-5, 5}, {-5, 5},
+                                     {-5, 5}, {-5, 5}, {-5, 5}, {-5, 5}};
+    std::vector<Counts> counts;
+    auto cycle = [&](int i) {
+        daq.read_all();
+        double pos = daq.encoder.positions[0] + daq.AI[i % 8];
+        daq.AO[i % 8] = pos;
+        daq.AO.set(Span<Volts>(volts, 8));
+        daq.AO.write(chs, Span<Volts>(volts, 3));
+        daq.AI.ranges.write(Span<Range<Volts>>(ranges, 8));
+        daq.DO.set(i % 8, i % 2 ? TTL_HIGH : TTL_LOW);
+        daq.encoder.snapshot(counts);
+        if (i % 1000 == 0)
+            daq.encoder.zero();
+        daq.write_all();
+    };
+
+    // the first cycle compiles the Daq's plan and sizes the snapshot copy
+    cycle(0);
+    g_armed = true;
+    for (int i = 1; i <= cycles; ++i)
+        cycle(i);
+    g_armed = false;
+
+    daq.disable();
+    daq.close();
+
+    print("Cycles:      {}", cycles);
+    print("Allocations: {}", g_allocations.load());
+    return g_allocations > 0 ? 1 : 0;
+}
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <chrono>
+#include <cmath>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example overlaps bus latency with compute using asynchronous reads (see AsyncIo.hpp).
+// A SimDaq with USB-like latency (~125 us per blocking transaction) runs the same cycle
+// twice: once with a blocking AI.read(), and once starting AI.read_async(), computing with
+// encoder data read in the previous cycle while the transaction is in flight, and joining
+// before the AI values are used. It exits non-zero if the results differ or the
+// asynchronous cycle is not faster.
+
+/// ~100 us of work on data that is already available
+double compute(const EncoderModule& enc) {
+    auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(100);
+    double u = 0;
+    while (std::chrono::steady_clock::now() < until)
+        u = 0.001 * enc.positions[0];
+    return u;
+}
+
+/// Runs cycles and returns the average cycle time in [us]
+double run(SimDaq& daq, int cycles, bool async, double& checksum) {
+    checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < cycles; ++i) {
+        double u;
+        if (async) {
+            IoCompletion ai = daq.AI.read_async();
+            u = compute(daq.encoder);
+            if (!ai.wait())
+                return -1;
+        }
+        else {
+            daq.AI.read();
+            u = compute(daq.encoder);
+        }
+        daq.AO[0] = std::fmod(u + 0.5 * daq.AI[0] + 0.1, 1.0);
+        daq.AO.write();
+        daq.encoder.read();
+        checksum += daq.AI[0];
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / cycles;
+}
+
+int main(int argc, char* argv[]) {
+    const int cycles = 1000;
+    SimDaq daq(SimLatency::Usb());
+    daq.encoder.increments[0] = 1;
+    daq.enable_async_io();
+    daq.enable();
+
+    double sync_sum, async_sum;
+    double sync_us = run(daq, cycles, false, sync_sum);
+    daq.AO.write(std::vector<Volts>(8, 0));
+    daq.encoder.zero();
+    double async_us = run(daq, cycles, true, async_sum);
+    daq.disable();
+
+    bool ok = async_us > 0 && async_us < sync_us && std::abs(sync_sum - async_sum) < 1e-9;
+    print("Blocking read:     {:.1f} us per cycle", sync_us);
+    print("Asynchronous read: {:.1f} us per cycle ({:.1f} us saved)", async_us, sync_us - async_us);
+    print("Results match:     {}", std::abs(sync_sum - async_sum) < 1e-9 ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
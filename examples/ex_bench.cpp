@@ -0,0 +1,281 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example measures the per-call overhead of the mahi::daq framework itself.
+// The DAQ below is software-only (see ex_custom.cpp), so its callbacks do almost
+// nothing and what remains is the cost of dispatching reads/writes to Modules. The
+// last comparison runs on a SimDaq with USB latency instead, where what matters is how
+// many device transactions each call makes.
+
+class BenchAI : public AIModule {
+public:
+    BenchAI(Daq& d, const ChanNums& allowed) : AIModule(d, allowed) {
+        set_name(d.name() + ".AI");
+        connect_read(*this, [](const ChanNum* chs, Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = 0.001 * chs[i];
+            return true;
+        });
+    }
+};
+
+class BenchDI : public DIModule {
+public:
+    BenchDI(Daq& d, const ChanNums& allowed) : DIModule(d, allowed) {
+        set_name(d.name() + ".DI");
+        connect_read(*this, [](const ChanNum* chs, TTL* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = chs[i] % 2 ? TTL_HIGH : TTL_LOW;
+            return true;
+        });
+    }
+};
+
+class BenchAO : public AOModule {
+public:
+    BenchAO(Daq& d, const ChanNums& allowed) : AOModule(d, allowed), ranges(*this, {-10, 10}) {
+        set_name(d.name() + ".AO");
+        connect_write(*this, [](const ChanNum*, const Volts*, std::size_t) { return true; });
+        connect_write(ranges, [](const ChanNum*, const Range<Volts>*, std::size_t) { return true; });
+    }
+    Register<Range<Volts>> ranges;
+};
+
+class BenchDO : public DOModule {
+public:
+    BenchDO(Daq& d, const ChanNums& allowed) : DOModule(d, allowed) {
+        set_name(d.name() + ".DO");
+        connect_write(*this, [](const ChanNum*, const TTL*, std::size_t) { return true; });
+    }
+};
+
+class BenchEncoder : public EncoderModule {
+public:
+    BenchEncoder(Daq& d, const ChanNums& allowed) : EncoderModule(d, allowed) {
+        set_name(d.name() + ".encoder");
+        connect_read(*this, [](const ChanNum* chs, Counts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] += static_cast<Counts>(chs[i]);
+            return true;
+        });
+        connect_write(*this, [](const ChanNum*, const Counts*, std::size_t) { return true; });
+        connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+    }
+};
+
+/// BenchAI with its read implementation bound at compile time instead of connected
+class BoundAI : public AIModule {
+public:
+    BoundAI(Daq& d, const ChanNums& allowed) : AIModule(d, allowed) {
+        set_name(d.name() + ".AI_bound");
+        bind_read<BoundAI, Volts, &BoundAI::read_impl>(*this);
+        read_with_all = false;
+    }
+private:
+    bool read_impl(const ChanNum* chs, Volts* vals, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i)
+            vals[i] = 0.001 * chs[i];
+        return true;
+    }
+};
+
+/// BenchAO with its write implementation bound at compile time instead of connected
+class BoundAO : public AOModule {
+public:
+    BoundAO(Daq& d, const ChanNums& allowed) : AOModule(d, allowed) {
+        set_name(d.name() + ".AO_bound");
+        bind_write<BoundAO, Volts, &BoundAO::write_impl>(*this);
+        write_with_all = false;
+    }
+private:
+    bool write_impl(const ChanNum*, const Volts*, std::size_t) { return true; }
+};
+
+class BenchDaq : public Daq {
+public:
+    BenchDaq() :
+        Daq("bench_daq"),
+        AI(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        AO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        DI(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        DO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        encoder(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        AI_bound(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+        AO_bound(*this, {0, 1, 2, 3, 4, 5, 6, 7}) {
+        AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        AO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        DI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        DO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        encoder.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        AI_bound.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        AO_bound.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        open();
+    }
+    ~BenchDaq() {
+        if (is_open())
+            close();
+    }
+    BenchAI      AI;
+    BenchAO      AO;
+    BenchDI      DI;
+    BenchDO      DO;
+    BenchEncoder encoder;
+    BoundAI      AI_bound;  // not part of read_all
+    BoundAO      AO_bound;  // not part of write_all
+};
+
+/// Runs func the requested number of iterations and returns the average time per call in ns
+template <typename F>
+double bench(F func, int iterations) {
+    for (int i = 0; i < iterations / 10; ++i)  // warm up
+        func();
+    Clock clk;
+    for (int i = 0; i < iterations; ++i)
+        func();
+    return 1000.0 * clk.get_elapsed_time().as_microseconds() / iterations;
+}
+
+/// The pre cycle-plan read_all: walk every Readable, check its flag, call its virtual read
+bool walk_read_all(const std::vector<Readable*>& readables) {
+    bool success = true;
+    for (auto& r : readables) {
+        if (r->read_with_all)
+            success = r->read() ? success : false;
+    }
+    return success;
+}
+
+/// The pre cycle-plan write_all: walk every Writeable, check its flag, call its virtual write
+bool walk_write_all(const std::vector<Writeable*>& writeables) {
+    bool success = true;
+    for (auto& w : writeables) {
+        if (w->write_with_all)
+            success = w->write() ? success : false;
+    }
+    return success;
+}
+
+int main(int argc, char* argv[]) {
+    if (MahiLogger)
+        MahiLogger->set_max_severity(Warning);
+
+    int iterations = 1000000;
+    if (argc > 1)
+        iterations = std::atoi(argv[1]);
+
+    BenchDaq daq;
+    // the same Buffers read_all/write_all visit, in construction order
+    std::vector<Readable*>  readables  = {&daq.AI, &daq.DI, &daq.encoder};
+    std::vector<Writeable*> writeables = {&daq.AO, &daq.AO.ranges,  &daq.DO,
+                                          &daq.encoder, &daq.encoder.modes};
+
+    print("Iterations: {}", iterations);
+    double walk_r = bench([&]() { walk_read_all(readables); }, iterations);
+    double plan_r = bench([&]() { daq.read_all(); }, iterations);
+    double walk_w = bench([&]() { walk_write_all(writeables); }, iterations);
+    double plan_w = bench([&]() { daq.write_all(); }, iterations);
+    print("read_all  (walk): {:8.1f} ns/call", walk_r);
+    print("read_all  (plan): {:8.1f} ns/call", plan_r);
+    print("write_all (walk): {:8.1f} ns/call", walk_w);
+    print("write_all (plan): {:8.1f} ns/call", plan_w);
+
+    // channel lookups, 8 per call so that each call touches every channel
+    volatile double sink = 0;
+    double set_op = bench([&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            daq.AO[ch] = ch;
+    }, iterations);
+    double get_op = bench([&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sink = sink + daq.AI[ch];
+    }, iterations);
+    double get_ch = bench([&]() {
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sink = sink + daq.AI.get(ch);
+    }, iterations);
+    print("ISet::operator[] x8: {:8.1f} ns/call", set_op);
+    print("IGet::operator[] x8: {:8.1f} ns/call", get_op);
+    print("IGet::get(ch)    x8: {:8.1f} ns/call", get_ch);
+
+    // per-read/write dispatch: connected util::Event vs compile-time bound member
+    double read_event  = bench([&]() { daq.AI.read(); }, iterations);
+    double read_bound  = bench([&]() { daq.AI_bound.read(); }, iterations);
+    double write_event = bench([&]() { daq.AO.write(); }, iterations);
+    double write_bound = bench([&]() { daq.AO_bound.write(); }, iterations);
+    print("IRead::read  (event): {:8.1f} ns/call", read_event);
+    print("IRead::read  (bound): {:8.1f} ns/call", read_bound);
+    print("IWrite::write(event): {:8.1f} ns/call", write_event);
+    print("IWrite::write(bound): {:8.1f} ns/call", write_bound);
+
+    // a "joint" of two AI channels, one encoder channel and one AO channel
+    AIHandle      ai0(daq.AI, 0), ai1(daq.AI, 1);
+    EncoderHandle enc0(daq.encoder, 0);
+    AOHandle      ao0(daq.AO, 0);
+    HandleGroup   joint;
+    joint.add(ai0);
+    joint.add(ai1);
+    joint.add(enc0);
+    joint.add(ao0);
+    double handles = bench([&]() { ai0.read(); ai1.read(); enc0.read(); ao0.write(); }, iterations);
+    double group   = bench([&]() { joint.read(); joint.write(); }, iterations);
+    print("Handles read/write     (overhead): {:8.1f} ns/call", handles);
+    print("HandleGroup read/write (overhead): {:8.1f} ns/call", group);
+
+    // the same comparison where every device transaction costs what it does on a USB DAQ:
+    // a joint of four AI, two encoder and two AO channels takes eight transactions through
+    // individual Handles but only three (AI, encoder, AO) through a HandleGroup
+    SimDaq sim(SimLatency::Usb());
+    sim.enable();
+    std::vector<AIHandle>      sim_ai;
+    std::vector<EncoderHandle> sim_enc;
+    std::vector<AOHandle>      sim_ao;
+    for (ChanNum ch = 0; ch < 4; ++ch)
+        sim_ai.emplace_back(sim.AI, ch);
+    for (ChanNum ch = 0; ch < 2; ++ch) {
+        sim_enc.emplace_back(sim.encoder, ch);
+        sim_ao.emplace_back(sim.AO, ch);
+    }
+    HandleGroup sim_joint;
+    for (auto& h : sim_ai)  sim_joint.add(h);
+    for (auto& h : sim_enc) sim_joint.add(h);
+    for (auto& h : sim_ao)  sim_joint.add(h);
+    auto sim_handles = [&]() {
+        for (auto& h : sim_ai)  h.read();
+        for (auto& h : sim_enc) h.read();
+        for (auto& h : sim_ao)  h.write();
+    };
+    auto sim_group = [&]() { sim_joint.read(); sim_joint.write(); };
+    int sim_iterations = std::max(iterations / 1000, 10);
+    double sim_handles_us = bench(sim_handles, sim_iterations) / 1000;
+    double sim_group_us   = bench(sim_group, sim_iterations) / 1000;
+    // count the device transactions of one call each
+    std::uint64_t before = sim.transactions();
+    sim_handles();
+    std::uint64_t handles_transactions = sim.transactions() - before;
+    before = sim.transactions();
+    sim_group();
+    std::uint64_t group_transactions = sim.transactions() - before;
+    print("Handles read/write     (SimDaq Usb): {:8.1f} us/call, {} transactions", sim_handles_us, handles_transactions);
+    print("HandleGroup read/write (SimDaq Usb): {:8.1f} us/call, {} transactions", sim_group_us, group_transactions);
+    sim.disable();
+    return 0;
+}
@@ -0,0 +1,117 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example shows change-only output writes (see IWrite::set_change_only). It cycles a
+// software-only DAQ with 56 digital outputs (like a QPID's DIO) and 8 analog outputs whose
+// "hardware" counts every channel written to it. Each cycle toggles one DO line and moves
+// the AOs slightly, mostly within their dead-bands. It then checks that far fewer channels
+// were written, and that the hardware still ends up matching the buffers. It exits non-zero
+// on a mismatch.
+
+/// A DO that costs one "register write" per channel
+class CountingDO : public DOModule {
+public:
+    CountingDO(Daq& d, const ChanNums& allowed) : DOModule(d, allowed), hardware(allowed.size(), TTL_LOW) {
+        set_name(d.name() + ".DO");
+        connect_write(*this, [this](const ChanNum* chs, const TTL* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                hardware[chs[i]] = vals[i];
+            writes += n;
+            return true;
+        });
+    }
+    std::vector<TTL> hardware;
+    std::size_t      writes = 0;
+};
+
+/// An AO that costs one "register write" per channel
+class CountingAO : public AOModule {
+public:
+    CountingAO(Daq& d, const ChanNums& allowed) : AOModule(d, allowed), hardware(allowed.size(), 0) {
+        set_name(d.name() + ".AO");
+        connect_write(*this, [this](const ChanNum* chs, const Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                hardware[chs[i]] = vals[i];
+            writes += n;
+            return true;
+        });
+    }
+    std::vector<Volts> hardware;
+    std::size_t        writes = 0;
+};
+
+class CountingDaq : public Daq {
+public:
+    CountingDaq() : Daq("counting_daq"), DO(*this, range(56)), AO(*this, range(8)) {
+        DO.set_channels(range(56));
+        AO.set_channels(range(8));
+    }
+    static ChanNums range(ChanNum n) {
+        ChanNums chs(n);
+        for (ChanNum i = 0; i < n; ++i)
+            chs[i] = i;
+        return chs;
+    }
+    CountingDO DO;
+    CountingAO AO;
+};
+
+/// Runs cycles and returns the number of channel writes
+std::size_t run(CountingDaq& daq, int cycles) {
+    daq.DO.writes = daq.AO.writes = 0;
+    for (int i = 0; i < cycles; ++i) {
+        daq.DO[i % 56] = daq.DO[i % 56] == TTL_HIGH ? TTL_LOW : TTL_HIGH;
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            daq.AO[ch] = 0.001 * (i / 10) + ch;  // steps by 1 mV every 10 cycles
+        daq.write_all();
+    }
+    return daq.DO.writes + daq.AO.writes;
+}
+
+int main(int argc, char* argv[]) {
+    const int cycles = 10000;
+    CountingDaq daq;
+    daq.open();
+    daq.enable();
+
+    std::size_t full = run(daq, cycles);
+
+    daq.DO.set_change_only(true, 1000);
+    daq.AO.set_change_only(true, 1000);
+    for (ChanNum ch = 0; ch < 8; ++ch)
+        daq.AO.set_deadband(ch, 0.0025);
+    std::size_t changes = run(daq, cycles);
+
+    bool ok = true;
+    for (ChanNum ch = 0; ch < 56; ++ch)
+        ok = daq.DO.hardware[ch] == daq.DO[ch] && ok;
+    for (ChanNum ch = 0; ch < 8; ++ch)
+        ok = std::abs(daq.AO.hardware[ch] - daq.AO[ch]) <= 0.0025 && ok;
+    ok = changes < full / 10 && ok;
+
+    daq.disable();
+    daq.close();
+    print("Channel writes, every channel: {}", full);
+    print("Channel writes, change-only:   {} ({} skipped)", changes, daq.DO.writes_skipped() + daq.AO.writes_skipped());
+    print("Hardware matches buffers:      {}", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
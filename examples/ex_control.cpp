@@ -41,38 +41,12 @@ private:
     double m_gain; // A/V
 };
 
-/// A simple structured environment for doing controls
-class ControlLoop {
-public:
-    ControlLoop(Daq& daq) : daq(daq) { }
-    void start() {
-        daq.enable();
-        running = true;
-        Timer timer(100_Hz);
-        Time t;
-        while (running) {
-            daq.read_all();
-            update(t);
-            daq.write_all();
-            t = timer.wait();
-        }
-        daq.disable();
-        daq.close();
-    }
-protected:
-    void stop() { running = false; }
-    virtual void update(Time t) { };
-    Daq& daq;
-private:
-    bool running;
-};
-
-/// Our custom implementation of ControLoop
+/// Our custom implementation of ControlLoop (see ControlLoop.hpp)
 class MyControlLoop : public ControlLoop {
 public:
     template <typename TDaq>
     MyControlLoop(TDaq& daq) : 
-        ControlLoop(daq), 
+        ControlLoop(daq, 100_Hz), 
         amp(daq.AO[0], daq.AI[0], 0.5) 
     { }
 private:
@@ -88,20 +62,43 @@ private:
     CurrentAmplifier amp;
 };
 
+/// Enables the DAQ, runs the loop, and prints how the cycles were spent
+void run(Daq& daq, MyControlLoop& loop) {
+    daq.enable();
+    loop.run();
+    daq.disable();
+    daq.close();
+    auto stats = loop.stats();
+    print("Cycles: {}, Misses: {}, Skipped: {}, Failures: {}", stats.cycles, stats.misses, stats.skipped, stats.failures);
+    auto print_hist = [](const char* name, const LatencyHistogram& h) {
+        auto s = h.stats();
+        print("{:<10} p50: {:>8} ns, p99: {:>8} ns, max: {:>8} ns", name, s.p50_ns, s.p99_ns, s.max_ns);
+    };
+    print_hist("I/O", loop.io_time());
+    print_hist("Compute", loop.compute_time());
+    print_hist("Idle", loop.idle_time());
+    print_hist("Lateness", loop.lateness());
+}
+
 int main(int argc, char const *argv[])
 {
 #ifdef MAHI_QUANSER
     Q8Usb q8;
     MyControlLoop loop(q8);
-    loop.start();
+    run(q8, loop);
 #elif MAHI_SENSORAY
     S826 s826;
     MyControlLoop loop(s826);
-    loop.start();
+    run(s826, loop);
 #elif MAHI_MYRIO
     MyRio myrio;
     MyControlLoop loop(myrio.mspC);
-    loop.start();
+    run(myrio, loop);
+#else
+    // no hardware, so control the simulated DAQ, whose AO0 loops back to AI0
+    SimDaq sim;
+    MyControlLoop loop(sim);
+    run(sim, loop);
 #endif
     return 0;
 }
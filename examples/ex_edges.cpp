@@ -0,0 +1,68 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example shows digital input edge detection (see DIModule::enable_edges) on a SimDaq,
+// whose DO channels loop back to its DI channels. DO channel ch toggles every 2 * (ch + 2) cycles,
+// and DO 7 additionally glitches for single cycles, which a debounce of 2 must reject. It
+// checks the edges reported by on_edge and exits non-zero on a mismatch.
+
+int main(int argc, char* argv[]) {
+    const int cycles = 1000;
+    SimDaq daq;
+    daq.enable();
+
+    int edges[8] = {0};
+    int rising   = 0;
+    daq.DI.enable_edges(true, 2);
+    daq.DI.on_edge.connect([&](ChanNum ch, bool rose) {
+        edges[ch]++;
+        rising += rose ? 1 : 0;
+    });
+
+    int expected[8] = {0};
+    for (int i = 0; i < cycles; ++i) {
+        for (ChanNum ch = 0; ch < 7; ++ch) {
+            TTL level = (i / (2 * (ch + 2))) % 2 ? TTL_HIGH : TTL_LOW;
+            // a change is accepted on the second read that sees it
+            if (i > 0 && level != daq.DO[ch])
+                expected[ch]++;
+            daq.DO[ch] = level;
+        }
+        daq.DO[7] = i % 10 == 5 ? TTL_HIGH : TTL_LOW;  // single cycle glitches
+        daq.write_all();
+        daq.read_all();
+    }
+
+    bool ok = edges[7] == 0;
+    for (ChanNum ch = 0; ch < 7; ++ch) {
+        // the last change may still be pending debounce
+        ok = (edges[ch] == expected[ch] || edges[ch] == expected[ch] - 1) && ok;
+        print("DI[{}]: {} edges (expected {})", ch, edges[ch], expected[ch]);
+    }
+    print("DI[7]: {} edges from glitches (expected 0)", edges[7]);
+    print("Rising: {}", rising);
+
+    daq.disable();
+    daq.close();
+    print("Edges match: {}", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <cstdlib>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example cycles three simulated USB DAQs (~125 us per transaction) first one
+// after another, then concurrently with a DaqGroup. Sequential cycles take the sum of
+// the three latencies; grouped cycles take roughly the slowest one. It also checks
+// that a failing device is reported without stalling the others, and exits non-zero
+// if the group is not faster or errors are misreported.
+
+/// A SimDaq whose reads can be made to fail
+class FlakyDaq : public SimDaq {
+public:
+    FlakyDaq() : SimDaq(SimLatency::Usb()), fail(false) {}
+    bool read_all() override { return SimDaq::read_all() && !fail; }
+    bool fail;
+};
+
+int main(int argc, char* argv[]) {
+    if (MahiLogger)
+        MahiLogger->set_max_severity(Warning);
+    int cycles = 2000;
+    if (argc > 1)
+        cycles = std::atoi(argv[1]);
+
+    SimDaq   a(SimLatency::Usb()), b(SimLatency::Usb());
+    FlakyDaq c;
+    a.enable();
+    b.enable();
+    c.enable();
+
+    Clock clk;
+    for (int i = 0; i < cycles; ++i) {
+        a.read_all();
+        b.read_all();
+        c.read_all();
+        a.write_all();
+        b.write_all();
+        c.write_all();
+    }
+    double sequential = (double)clk.get_elapsed_time().as_microseconds() / cycles;
+
+    bool ok = true;
+    {
+        // e.g. pass {RealtimeOptions(), RealtimeOptions(2, 80), RealtimeOptions(3, 80)} to pin workers
+        DaqGroup group({&a, &b, &c});
+        clk.restart();
+        for (int i = 0; i < cycles; ++i) {
+            ok = group.read_all() && ok;
+            ok = group.write_all() && ok;
+        }
+        double grouped = (double)clk.get_elapsed_time().as_microseconds() / cycles;
+        print("Sequential cycle: {:7.1f} us", sequential);
+        print("DaqGroup cycle:   {:7.1f} us ({:.2f}x)", grouped, sequential / grouped);
+        if (!ok || grouped > 0.8 * sequential)
+            ok = false;
+
+        // per-device error aggregation
+        c.fail = true;
+        bool result = group.read_all();
+        print("With c failing:   result = {}, a/b/c succeeded = {}/{}/{}, c failures = {}", result,
+              group.succeeded(0), group.succeeded(1), group.succeeded(2), group.failures(2));
+        if (result || !group.succeeded(0) || !group.succeeded(1) || group.succeeded(2) || group.failures(2) != 1)
+            ok = false;
+        c.fail = false;
+    }
+
+    a.disable();
+    b.disable();
+    c.disable();
+    print("{}", ok ? "DaqGroup OK" : "DaqGroup FAILED");
+    return ok ? 0 : 1;
+}
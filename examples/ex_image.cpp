@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <cstring>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example shows a Daq's process image, which packs every Buffer's values into one
+// contiguous block so that a whole cycle can be copied with a single memcpy. It cycles a
+// SimDaq (AO loops back to AI), checks that the image matches the Buffers, changes the
+// AI channels to force a new layout, and checks again. It exits non-zero on a mismatch.
+
+/// Returns true if the values of buffer in image match values
+template <typename T>
+bool matches(const ProcessImage& image, const std::vector<unsigned char>& copy, const BufferBase& buffer, const std::vector<T>& values) {
+    std::size_t offset = image.offset(buffer);
+    if (offset == ProcessImage::npos)
+        return values.empty();
+    return std::memcmp(&copy[offset], values.data(), values.size() * sizeof(T)) == 0;
+}
+
+int main(int argc, char* argv[]) {
+    SimDaq daq;
+    daq.enable_process_image();
+    daq.enable();
+
+    std::vector<unsigned char> copy;
+    bool ok = true;
+    for (int layout = 0; layout < 2; ++layout) {
+        for (int i = 0; i < 100; ++i) {
+            for (auto& ch : daq.AO.channels())
+                daq.AO[ch] = 0.01 * i + ch;
+            daq.DO[0] = i % 2 ? TTL_HIGH : TTL_LOW;
+            daq.write_all();
+            daq.read_all();
+            // one copy of the entire cycle
+            const ProcessImage& image = *daq.process_image();
+            copy.resize(image.size());
+            image.copy(copy.data());
+            ok = matches(image, copy, daq.AI, daq.AI.get()) && ok;
+            ok = matches(image, copy, daq.DI, daq.DI.get()) && ok;
+            ok = matches(image, copy, daq.encoder, daq.encoder.get()) && ok;
+            ok = matches(image, copy, daq.AO, daq.AO.get()) && ok;
+            ok = matches(image, copy, daq.DO, daq.DO.get()) && ok;
+        }
+        const ProcessImage& image = *daq.process_image();
+        print("Layout {}: {} bytes ({} input, {} output) in {} input and {} output sections", 
+              image.layout_count(), image.size(), image.inputs_size(), image.outputs_size(),
+              image.input_sections().size(), image.output_sections().size());
+        // changing channels relays the image on the next cycle
+        daq.AI.set_channels({0, 2, 4});
+    }
+
+    daq.disable();
+    daq.close();
+    print("Image matches Buffers: {}", ok ? "yes" : "NO");
+    return ok ? 0 : 1;
+}
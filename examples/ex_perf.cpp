@@ -106,7 +106,7 @@ int main(int argc, char* argv[]) {
 
     Options options("perf.exe", "Utility Program to Evaluate DAQ Analog Loopback Performance");
     options.add_options()
-        ("d", "The type of DAQ to test (q2, q8, qpid, s826, myrio, or cpu).", value<std::string>())
+        ("d", "The type of DAQ to test (q2, q8, qpid, s826, myrio, sim, sim-usb, sim-pcie, or cpu).", value<std::string>())
         ("f", "The target frequency in Hz (default = 1000).",                 value<int>())
         ("t", "The test duration in seconds (default = 10).",                 value<int>())
         ("i", "Input channel for loopback (default = 0)",                     value<int>())
@@ -144,7 +144,15 @@ int main(int argc, char* argv[]) {
         auto str = user_input["d"].as<std::string>();
         if (str == "cpu") {
             return cpu_test(frequency, time);
-        }        
+        }
+        else if (str == "sim" || str == "sim-usb" || str == "sim-pcie") {
+            SimLatency latency = str == "sim-usb"  ? SimLatency::Usb()
+                               : str == "sim-pcie" ? SimLatency::Pcie()
+                                                   : SimLatency::None();
+            SimDaq sim(latency);
+            sim.enable();
+            return analog_test(sim, frequency, time, ai, ao, save);
+        }
 #ifdef MAHI_QUANSER
         else if (str == "q2") {
             Q2Usb q2;
@@ -0,0 +1,35 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// Converts a Recorder binary recording (see ex_record.cpp) to CSV, e.g.
+// rec2csv run.mrec run.csv
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        print("usage: rec2csv <recording> <csv>");
+        return 1;
+    }
+    if (!Recorder::to_csv(argv[1], argv[2]))
+        return 1;
+    print("Converted {} to {}", argv[1], argv[2]);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <cmath>
+#include <cstdlib>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example records 8 AI channels and an encoder at 4 kHz with a Recorder while
+// a DaqThread cycles a software-only DAQ (see ex_custom.cpp). It first measures what
+// Recorder::record costs the real-time thread per cycle, then records for a few
+// seconds and converts the result to CSV (see also ex_rec2csv.cpp). It exits
+// non-zero if any rows were dropped or lost.
+
+/// An AI whose channels read a sine wave offset by their channel number
+class WaveAI : public AIModule {
+public:
+    WaveAI(Daq& d, const ChanNums& allowed) : AIModule(d, allowed), t(0) {
+        set_name(d.name() + ".AI");
+        connect_read(*this, [this](const ChanNum* chs, Volts* vals, std::size_t n) {
+            t += 0.00025;
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = chs[i] + std::sin(TWOPI * t);
+            return true;
+        });
+    }
+    double t;
+};
+
+/// An encoder that counts up every read
+class CountingEncoder : public EncoderModule {
+public:
+    CountingEncoder(Daq& d, const ChanNums& allowed) : EncoderModule(d, allowed) {
+        set_name(d.name() + ".encoder");
+        connect_read(*this, [](const ChanNum*, Counts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] += 1;
+            return true;
+        });
+        connect_write(*this, [](const ChanNum*, const Counts*, std::size_t) { return true; });
+        connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+    }
+};
+
+class RecDaq : public Daq {
+public:
+    RecDaq() : Daq("rec_daq"), AI(*this, {0, 1, 2, 3, 4, 5, 6, 7}), encoder(*this, {0, 1}) {
+        AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        encoder.set_channels({0, 1});
+    }
+    WaveAI          AI;
+    CountingEncoder encoder;
+};
+
+int main(int argc, char* argv[]) {
+    int seconds_to_record = 3;
+    if (argc > 1)
+        seconds_to_record = std::atoi(argv[1]);
+
+    RecDaq daq;
+    daq.open();
+    daq.enable();
+
+    // what record costs the real-time thread per cycle; the ring is sized so that nothing
+    // is dropped while the writer thread drains it concurrently
+    const int iterations = 1000000;
+    Recorder  bench(iterations);
+    for (ChanNum ch = 0; ch < 8; ++ch)
+        bench.add(daq.AI, ch);
+    bench.add(EncoderHandle(daq.encoder, 1), "joint1");
+    bench.open("ex_record_bench.mrec");
+    Clock clk;
+    for (int i = 0; i < iterations; ++i)
+        bench.record(microseconds(i));
+    double ns = 1000.0 * clk.get_elapsed_time().as_microseconds() / iterations;
+    bench.close();
+    print("Recorder::record ({} columns): {:.1f} ns/cycle", bench.columns().size(), ns);
+
+    Recorder rec(16384);
+    for (ChanNum ch = 0; ch < 8; ++ch)
+        rec.add(daq.AI, ch);
+    rec.add(EncoderHandle(daq.encoder, 1), "joint1");
+
+    // a real-time style run at 4 kHz
+    DaqThread thread(daq, hertz(4000));
+    thread.update = [&](Time t) { rec.record(t); };
+    rec.open("ex_record.mrec");
+    thread.start();
+    sleep(seconds(seconds_to_record));
+    thread.stop();
+    rec.close();
+
+    print("Recorded {} rows at 4 kHz ({} dropped, {} written)", rec.recorded(), rec.dropped(), rec.written());
+    Recorder::to_csv("ex_record.mrec", "ex_record.csv");
+    print("Converted ex_record.mrec to ex_record.csv");
+
+    daq.disable();
+    daq.close();
+    return rec.dropped() == 0 && rec.written() == rec.recorded() ? 0 : 1;
+}
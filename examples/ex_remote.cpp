@@ -0,0 +1,108 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <cstdlib>
+#include <cstring>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example drives a SimDaq through a DaqServer and a RemoteDaq. By default both run in
+// this process over loopback: the client checks that each write_read_all exchange returns
+// the loopback of the outputs it carried, that immediate reads and writes work, and prints
+// round trip times. It exits non-zero on a mismatch. Run "ex_remote serve [port] [address]"
+// on one machine (address 0.0.0.0 serves every interface; the default is loopback only) and
+// "ex_remote <host> [port]" on another to run the same check over a network.
+
+/// Runs the client checks and returns true if they passed
+bool run_client(const std::string& host, unsigned short port) {
+    RemoteDaq rio(host, port);
+    if (!rio.is_connected() || !rio.AI() || !rio.AO() || !rio.DI() || !rio.DO() || !rio.encoder())
+        return false;
+    AIModule& ai = *rio.AI();
+    AOModule& ao = *rio.AO();
+    DIModule& di = *rio.DI();
+    DOModule& dout = *rio.DO();
+    print("Mirrored {}, {}, {}, {} and {}", ai.name(), ao.name(), di.name(), dout.name(), rio.encoder()->name());
+    rio.enable();
+
+    const int cycles = 5000;
+    int mismatches = 0;
+    double rtt_us = 0, server_us = 0;
+    Counts last = 0;
+    for (int i = 0; i < cycles; ++i) {
+        for (ChanNum ch = 0; ch < 8; ++ch) {
+            ao[ch]   = 0.001 * i + ch;
+            dout[ch] = (i >> ch) & 1 ? TTL_HIGH : TTL_LOW;
+        }
+        if (!rio.write_read_all()) {
+            ++mismatches;
+            continue;
+        }
+        for (ChanNum ch = 0; ch < 8; ++ch) {
+            if (ai[ch] != ao[ch] || di[ch] != dout[ch])
+                ++mismatches;
+        }
+        if ((*rio.encoder())[1] <= last)
+            ++mismatches;
+        last = (*rio.encoder())[1];
+        rtt_us += rio.round_trip().as_microseconds();
+        server_us += rio.server_time().as_microseconds();
+    }
+    // immediate mode: one exchange each
+    bool immediate = ao.write(3, 1.25) && ai.read(3) && ai[3] == 1.25;
+
+    rio.disable();
+    print("{} cycles, {} mismatches, {} retransmissions", cycles, mismatches, rio.retransmissions());
+    print("Round trip: {:.1f} us average ({:.1f} us on the server's Daq)", rtt_us / cycles, server_us / cycles);
+    print("Immediate write/read: {}", immediate ? "ok" : "FAILED");
+    return mismatches == 0 && immediate;
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short port = argc > 2 ? static_cast<unsigned short>(std::atoi(argv[2])) : RemotePort;
+    if (argc > 1 && std::strcmp(argv[1], "serve") == 0) {
+        SimDaq daq;
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            daq.encoder.increments[ch] = ch + 1;
+        DaqServer server(daq);
+        std::string address = argc > 3 ? argv[3] : "127.0.0.1";
+        if (!server.open(port, address))
+            return 1;
+        print("Serving {} on {}:{}", daq.name(), address, server.port());
+        while (true)
+            server.poll(seconds(1));
+    }
+    if (argc > 1)
+        return run_client(argv[1], port) ? 0 : 1;
+
+    SimDaq daq;
+    for (ChanNum ch = 0; ch < 8; ++ch)
+        daq.encoder.increments[ch] = ch + 1;
+    DaqServer server(daq);
+    if (!server.open(0) || !server.start())
+        return 1;
+    bool ok = run_client("127.0.0.1", server.port());
+    // the server belongs to the first client until it has been silent for a second
+    RemoteDaq other("127.0.0.1", server.port());
+    bool refused = !other.is_connected();
+    server.close();
+    print("Server answered {} cycles", server.cycles());
+    print("Second client refused: {}", refused ? "yes" : "NO");
+    return ok && refused ? 0 : 1;
+}
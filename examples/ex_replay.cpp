@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <chrono>
+#include <cstdio>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example shows record and replay (see Trace.hpp and ReplayDaq.hpp). It runs a simple
+// controller on a software-only DAQ while a TraceWriter logs every read and write, then
+// replays the trace through the same controller at full CPU speed and checks that it wrote
+// exactly what was recorded. A slightly retuned controller is replayed too, to show that
+// the change is caught as output mismatches. It exits non-zero if either check fails.
+
+/// One control cycle: every input feeds the output on the same channel
+void control(const AIModule& ai, const DIModule& di, EncoderModule& enc, AOModule& ao, DOModule& dout, double gain) {
+    for (ChanNum ch = 0; ch < 8; ++ch) {
+        double u = gain * ai[ch] + 0.001 * (enc[ch] % 1000) + (di[ch] == TTL_HIGH ? 0.05 : -0.05);
+        ao[ch]   = u;
+        dout[ch] = u > 0.5 ? TTL_HIGH : TTL_LOW;
+    }
+}
+
+/// Replays the trace with the controller gain and returns the number of cycles
+int replay(ReplayDaq& daq, double gain, double& seconds) {
+    AIModule&      ai   = *daq.AI();
+    DIModule&      di   = *daq.DI();
+    EncoderModule& enc  = *daq.encoder();
+    AOModule&      ao   = *daq.AO();
+    DOModule&      dout = *daq.DO();
+    int cycles = 0;
+    auto start = std::chrono::steady_clock::now();
+    daq.enable();
+    while (daq.read_all()) {
+        control(ai, di, enc, ao, dout, gain);
+        daq.write_all();
+        ++cycles;
+    }
+    daq.disable();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return cycles;
+}
+
+int main(int argc, char* argv[]) {
+    const int   cycles = 20000;
+    const char* file   = "ex_replay.mtrc";
+
+    // record
+    {
+        SimDaq sim;
+        for (ChanNum ch = 0; ch < 8; ++ch)
+            sim.encoder.increments[ch] = ch + 1;
+        TraceWriter trace;
+        if (!trace.open(sim, file))
+            return 1;
+        sim.enable();
+        for (int i = 0; i < cycles; ++i) {
+            sim.read_all();
+            control(sim.AI, sim.DI, sim.encoder, sim.AO, sim.DO, 0.9);
+            sim.write_all();
+        }
+        sim.disable();
+        trace.close();
+        print("Recorded {} cycles ({} records)", cycles, trace.records());
+    }
+
+    // replay
+    ReplayDaq daq(file);
+    if (!daq.is_loaded() || !daq.AI() || !daq.DI() || !daq.encoder() || !daq.AO() || !daq.DO())
+        return 1;
+    double seconds;
+    int replayed = replay(daq, 0.9, seconds);
+    std::uint64_t mismatches = daq.output_mismatches();
+    print("Replayed {} cycles in {:.3f} ms ({:.1f} M cycles/s), {} outputs compared, {} mismatches",
+          replayed, seconds * 1000, replayed / seconds / 1e6, daq.outputs_compared(), mismatches);
+
+    daq.rewind();
+    replay(daq, 0.91, seconds);
+    print("Retuned controller: {} mismatches, max error {:.4f}", daq.output_mismatches(), daq.max_output_error());
+
+    bool ok = replayed == cycles && mismatches == 0 && daq.output_mismatches() > 0;
+    std::remove(file);
+    print("Replay {}", ok ? "matches" : "FAILED");
+    return ok ? 0 : 1;
+}
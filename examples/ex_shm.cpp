@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example publishes a SimDaq's state to shared memory with ShmPublisher and reads it
+// back with ShmReader. Run "ex_shm" to publish for 5 seconds while an in-process reader
+// checks that every cycle it sees is consistent (exits non-zero otherwise), or run
+// "ex_shm read" in a second terminal meanwhile to watch from another process.
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "read") == 0) {
+        ShmReader reader;
+        if (!reader.open("mahi_daq_ex_shm"))
+            return 1;
+        for (auto& c : reader.channels())
+            print("{}[{}]", c.module, c.channel);
+        while (reader.update() || reader.open("mahi_daq_ex_shm")) {
+            print("cycle {:>8}  t = {:.3f} s  AI[0] = {:+.3f}", reader.cycle(), reader.time().as_seconds(), reader.value(0));
+            sleep(100_ms);
+        }
+        return 0;
+    }
+
+    SimDaq daq;
+    daq.enable();
+    ShmPublisher pub("mahi_daq_ex_shm");
+    pub.add(daq.AI);
+    pub.add(daq.encoder);
+    if (!pub.open())
+        return 1;
+
+    // every AI channel reads the same value each cycle, so a torn read would show as a mismatch
+    std::atomic<bool> done(false);
+    std::uint64_t updates = 0, torn = 0;
+    std::thread watcher([&]() {
+        ShmReader reader;
+        if (!reader.open("mahi_daq_ex_shm"))
+            return;
+        while (!done) {
+            if (!reader.update())
+                continue;
+            updates++;
+            for (std::size_t i = 0; i < daq.AI.channels().size(); ++i) {
+                if (reader.value(i) != reader.value(0))
+                    torn++;
+            }
+        }
+    });
+
+    Timer timer(1000_Hz);
+    Time t;
+    while (t < 5_s) {
+        for (auto& ch : daq.AO.channels())
+            daq.AO[ch] = std::sin(TWOPI * t.as_seconds());
+        daq.write_all();
+        daq.read_all();
+        pub.publish(t);
+        t = timer.wait();
+    }
+    done = true;
+    watcher.join();
+    pub.close();
+    daq.disable();
+    daq.close();
+
+    print("Published: {}, Reader updates: {}, Torn: {}", pub.published(), updates, torn);
+    return torn == 0 && updates > 0 ? 0 : 1;
+}
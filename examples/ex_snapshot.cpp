@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example shows how non-RT threads (e.g. a GUI or logger) can safely observe
+// Module Buffers while a control thread is calling read_all. It doubles as a
+// stress test: one writer thread reads a software DAQ as fast as possible, while
+// several reader threads fetch snapshots and check that they are never torn.
+
+/// An AI Module whose every channel reads the same, ever increasing, value. Any
+/// snapshot that contains differing values was torn.
+class CountingAI : public AIModule {
+public:
+    CountingAI(Daq& d, const ChanNums& allowed) : AIModule(d, allowed), count(0) {
+        set_name(d.name() + ".AI");
+        connect_read(*this, [this](const ChanNum*, Volts* vals, std::size_t n) {
+            count += 1;
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = count;
+            return true;
+        });
+    }
+    double count;
+};
+
+/// An encoder Module whose counts all equal the number of reads
+class CountingEncoder : public EncoderModule {
+public:
+    CountingEncoder(Daq& d, const ChanNums& allowed) : EncoderModule(d, allowed) {
+        set_name(d.name() + ".encoder");
+        connect_read(*this, [](const ChanNum*, Counts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] += 1;
+            return true;
+        });
+    }
+};
+
+class CountingDaq : public Daq {
+public:
+    CountingDaq() :
+        Daq("counting_daq"),
+        AI(*this, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}),
+        encoder(*this, {0, 1, 2, 3, 4, 5, 6, 7}) {
+        AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15});
+        encoder.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    }
+    CountingAI      AI;
+    CountingEncoder encoder;
+};
+
+int main(int argc, char* argv[]) {
+    int num_readers = 4;
+    if (argc > 1)
+        num_readers = std::atoi(argv[1]);
+    Time duration = seconds(2);
+
+    CountingDaq daq;
+    // opt in to snapshots on startup, before any other threads look at them
+    daq.AI.enable_snapshots();
+    daq.encoder.enable_snapshots();
+    daq.encoder.units.set(std::vector<double>(8, 0.5));
+
+    std::atomic<bool> done(false);
+    std::atomic<long> torn(0);
+    std::atomic<long> fetches(0);
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < num_readers; ++r) {
+        readers.emplace_back([&]() {
+            std::vector<Volts>  ai;
+            std::vector<Counts> counts;
+            std::vector<double> positions;
+            std::uint64_t       last_cycle = 0, counts_cycle = 0, positions_cycle = 0;
+            while (!done) {
+                std::uint64_t cycle;
+                if (!daq.AI.snapshot(ai, &cycle))
+                    continue;
+                fetches++;
+                // all channels must come from the same read, and cycles must never go backwards
+                for (auto& v : ai) {
+                    if (v != ai[0])
+                        torn++;
+                }
+                if (cycle < last_cycle)
+                    torn++;
+                last_cycle = cycle;
+                // counts and positions published on the same cycle must agree
+                if (daq.encoder.snapshot(counts, &counts_cycle) &&
+                    daq.encoder.positions.snapshot(positions, &positions_cycle) &&
+                    counts_cycle == positions_cycle) {
+                    for (std::size_t i = 0; i < counts.size(); ++i) {
+                        if (positions[i] != counts[i] * 0.5 / 4.0)
+                            torn++;
+                    }
+                }
+            }
+        });
+    }
+
+    long  reads = 0;
+    Clock clk;
+    while (clk.get_elapsed_time() < duration) {
+        daq.read_all();
+        reads++;
+    }
+    done = true;
+    for (auto& r : readers)
+        r.join();
+
+    print("Readers:       {}", num_readers);
+    print("Writer reads:  {}", reads);
+    print("Reader copies: {}", fetches.load());
+    print("Torn copies:   {}", torn.load());
+    return torn > 0 ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example acquires two analog inputs at 10 kHz with a hardware-timed stream
+// (StreamingInputModule) on the simulated DAQ, draining up to 1000 scans per call
+// instead of making one read per sample. It then stops reading long enough for the
+// backend buffer to overflow, to show overrun detection. It exits non-zero if the
+// blocks are not contiguous or the overrun goes unnoticed.
+
+int main(int argc, char const* argv[]) {
+    SimDaq daq(SimLatency::Usb());
+    daq.enable();
+    daq.AO[0] = 1.0;
+    daq.AO[1] = -1.0;
+    daq.AO.write();
+
+    daq.stream.set_channels({0, 1});
+    daq.stream.set_sample_rate(10000);
+    daq.stream.set_buffer_size(5000);
+    StreamBlock<Volts> block(1000, 2);
+
+    daq.stream.start();
+    bool          ok       = true;
+    std::uint64_t expected = 0;
+    std::size_t   reads    = 0;
+    Clock clk;
+    while (clk.get_elapsed_time() < seconds(1)) {
+        sleep(milliseconds(20));
+        if (!daq.stream.read(block))
+            ok = false;
+        if (block.first_scan != expected || block.overrun)
+            ok = false;
+        expected = block.first_scan + block.scans;
+        reads++;
+        if (block.scans > 0 && (block(0, 0) != 1.0 || block(block.scans - 1, 1) != -1.0))
+            ok = false;
+    }
+    print("Read {} scans in {} calls ({:.1f} scans/call), last block at nominal t = {} us",
+          expected, reads, (double)expected / reads, block.timestamp.as_microseconds());
+
+    // channels are fixed while streaming
+    if (daq.stream.set_channels({0}) || daq.stream.channels().size() != 2)
+        ok = false;
+
+    // fall behind by more than the 5000 scan buffer
+    sleep(seconds(1));
+    daq.stream.read(block);
+    print("After stalling: overrun = {}, lost {} scans", block.overrun ? "yes" : "no", daq.stream.overruns());
+    if (!block.overrun || block.first_scan != expected + daq.stream.overruns())
+        ok = false;
+    daq.stream.stop();
+
+    daq.disable();
+    print("{}", ok ? "Stream OK" : "Stream FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#include <Mahi/Daq.hpp>
+#include <Mahi/Util.hpp>
+
+using namespace mahi::daq;
+using namespace mahi::util;
+
+// This example runs a DAQ on its own acquisition thread with QueuedDaqThread. The
+// application thread never touches the DAQ; it receives inputs and sends outputs through
+// the thread's wait-free queues. A software loopback DAQ is used so the example runs
+// anywhere, but any Daq (e.g. Q8Usb) can be used the same way. It exits non-zero if a
+// cycle failed, if more than 1% of cycles overran (without real-time settings, the OS may
+// preempt a few), or if the outputs sent were not read back.
+
+/// AO Module that stores what it writes so that LoopbackAI can read it back
+class LoopbackAO : public AOModule {
+public:
+    LoopbackAO(Daq& d, const ChanNums& allowed) : AOModule(d, allowed), wired(8, 0) {
+        set_name(d.name() + ".AO");
+        connect_write(*this, [this](const ChanNum* chs, const Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                wired[chs[i]] = vals[i];
+            return true;
+        });
+    }
+    std::vector<Volts> wired;
+};
+
+/// AI Module that reads back whatever LoopbackAO last wrote
+class LoopbackAI : public AIModule {
+public:
+    LoopbackAI(Daq& d, const ChanNums& allowed, LoopbackAO& ao) : AIModule(d, allowed) {
+        set_name(d.name() + ".AI");
+        connect_read(*this, [&ao](const ChanNum* chs, Volts* vals, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i)
+                vals[i] = ao.wired[chs[i]];
+            return true;
+        });
+    }
+};
+
+class LoopbackDaq : public Daq {
+public:
+    LoopbackDaq() :
+        Daq("loopback_daq"), AO(*this, {0, 1, 2, 3, 4, 5, 6, 7}), AI(*this, {0, 1, 2, 3, 4, 5, 6, 7}, AO) {
+        AO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+        AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    }
+    LoopbackAO AO;
+    LoopbackAI AI;
+};
+
+/// What the acquisition thread sends to the application each cycle
+struct Inputs {
+    Time  t;
+    Volts ai0;
+};
+
+int main(int argc, char const* argv[]) {
+    LoopbackDaq daq;
+    daq.open();
+    daq.enable();
+
+    // pass e.g. RealtimeOptions(1, 80, true) to pin to CPU 1 with SCHED_FIFO 80 and mlockall
+    QueuedDaqThread<Inputs, Volts> thread(daq, hertz(1000), 1024);
+    thread.sample = [&](Time t) {
+        Inputs in = {t, daq.AI[0]};
+        return in;
+    };
+    thread.apply = [&](const Volts& v) { daq.AO[0] = v; };
+    thread.start();
+
+    // the application runs at its own, slower and jittery, pace
+    Clock  clk;
+    Inputs in;
+    Volts  sent = 0;
+    bool   looped_back = false;  // true once an output sent came back as an input
+    while (clk.get_elapsed_time() < seconds(2)) {
+        Volts latest = 0;
+        std::size_t received = 0;
+        while (thread.inputs.pop(in)) {
+            latest = in.ai0;
+            looped_back = looped_back || (sent != 0 && in.ai0 == sent);
+            received++;
+        }
+        sent = 5 * std::sin(TWOPI * clk.get_elapsed_time().as_seconds()) + 6;
+        thread.outputs.push(sent);
+        print("received {:3} inputs, AI[0] = {:+.3f} V", received, latest);
+        sleep(milliseconds(100));
+    }
+    thread.stop();
+
+    auto stats = thread.stats();
+    print("Cycles:      {}", stats.cycles);
+    print("Overruns:    {}", stats.overruns);
+    print("I/O Errors:  {}", stats.io_failures);
+    print("Dropped:     {}", thread.inputs_dropped());
+    print("Max Cycle:   {} us", stats.max_cycle.as_microseconds());
+    print("Max Overrun: {} us", stats.max_overrun.as_microseconds());
+    print("Looped back: {}", looped_back ? "yes" : "NO");
+    print_latency(daq);
+
+    daq.disable();
+    daq.close();
+    bool on_time = stats.cycles > 0 && stats.overruns * 100 <= stats.cycles;
+    return on_time && stats.io_failures == 0 && looped_back ? 0 : 1;
+}
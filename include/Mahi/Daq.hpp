@@ -23,6 +23,23 @@
 #include <Mahi/Daq/Watchdog.hpp>
 #include <Mahi/Daq/Utils.hpp>
 #include <Mahi/Daq/Handle.hpp>
+#include <Mahi/Daq/Snapshot.hpp>
+#include <Mahi/Daq/SpscQueue.hpp>
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Daq/AsyncIo.hpp>
+#include <Mahi/Daq/DaqThread.hpp>
+#include <Mahi/Daq/DaqGroup.hpp>
+#include <Mahi/Daq/ControlLoop.hpp>
+#include <Mahi/Daq/Metrics.hpp>
+#include <Mahi/Daq/ProcessImage.hpp>
+#include <Mahi/Daq/Recorder.hpp>
+#include <Mahi/Daq/Shm.hpp>
+#include <Mahi/Daq/Trace.hpp>
+#include <Mahi/Daq/Streaming.hpp>
+#include <Mahi/Daq/Sim/SimDaq.hpp>
+#include <Mahi/Daq/Replay/ReplayDaq.hpp>
+#include <Mahi/Daq/Remote/DaqServer.hpp>
+#include <Mahi/Daq/Remote/RemoteDaq.hpp>
 
 #ifdef MAHI_QUANSER
     #include <Mahi/Daq/Quanser/Q2Usb.hpp>
@@ -0,0 +1,119 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace mahi {
+namespace daq {
+
+class IoWorker;
+
+/// A handle to an asynchronous read or write (see Readable::read_async, Writeable::write_async
+/// and Daq::read_all_async). It is two words and allocates nothing. Do not touch the Buffers
+/// involved until the operation has been waited on.
+///
+/// IoCompletion ai = q8.AI.read_async();  // the USB round trip starts on the I/O worker
+/// double u = controller(q8.encoder[0]);  // meanwhile, compute with data already read
+/// if (ai.wait())                         // join before using the AI values
+///     q8.AO[0] = u + k * q8.AI[0];
+class IoCompletion {
+public:
+    /// Constructs an invalid handle
+    IoCompletion() : m_worker(nullptr), m_ticket(0) {}
+    /// Returns true if this handle refers to an operation
+    bool valid() const { return m_worker != nullptr; }
+    /// Returns true once the operation has finished (true for invalid handles)
+    bool ready() const;
+    /// Blocks until the operation has finished and returns its result (false for invalid
+    /// handles). Results are kept for the last IoWorker::Capacity operations of a Daq, so
+    /// wait before submitting that many more.
+    bool wait() const;
+
+private:
+    friend IoWorker;
+    /// Constructor
+    IoCompletion(IoWorker* worker, std::uint64_t ticket) : m_worker(worker), m_ticket(ticket) {}
+    IoWorker*     m_worker;  ///< the worker running the operation
+    std::uint64_t m_ticket;  ///< the operation's place in the worker's queue
+};
+
+/// A thread that runs a Daq's asynchronous reads and writes one at a time, in submission
+/// order, so that they never overlap each other on the DAQ's bus or driver. Jobs are plain
+/// function pointers queued in a fixed ring, so submitting does not allocate.
+class IoWorker : util::NonCopyable {
+public:
+    /// A job: performs the I/O on target and returns its success
+    typedef bool (*Job)(void* target);
+    /// Maximum number of operations in flight (submit blocks beyond it)
+    static const std::size_t Capacity = 64;
+    /// Constructor. Starts the thread with the given real-time settings.
+    IoWorker(const RealtimeOptions& options);
+    /// Destructor. Finishes the operation in progress, discards those queued, then stops the
+    /// thread.
+    ~IoWorker();
+    /// Queues job on target and returns its handle
+    IoCompletion submit(Job job, void* target);
+    /// Blocks until every submitted operation has finished
+    void drain();
+    /// Discards the operations not yet started (their handles wait to false), then blocks
+    /// until the one in progress has finished
+    void cancel();
+
+private:
+    friend IoCompletion;
+    /// A queued or finished operation
+    struct Slot {
+        Job           job;     ///< the job
+        void*         target;  ///< its target
+        std::uint64_t ticket;  ///< its ticket
+        bool          result;  ///< its result once finished
+    };
+    /// Returns true once ticket has finished
+    bool ready(std::uint64_t ticket) const { return m_completed.load(std::memory_order_acquire) >= ticket; }
+    /// Blocks until ticket has finished and returns its result
+    bool wait(std::uint64_t ticket);
+    /// Worker thread entry point
+    void run(RealtimeOptions options);
+
+private:
+    Slot                       m_slots[Capacity];  ///< ring of operations, by ticket
+    std::uint64_t              m_submitted;        ///< last ticket issued
+    std::atomic<std::uint64_t> m_completed;        ///< last ticket finished
+    std::uint64_t              m_discarded;        ///< last ticket discarded by cancel
+    bool                       m_stop;             ///< true when the thread should exit
+    std::mutex                 m_mutex;            ///< guards m_slots, m_submitted, m_discarded and m_stop
+    std::condition_variable    m_queued;           ///< signaled when an operation is queued
+    std::condition_variable    m_finished;         ///< signaled when an operation finishes
+    std::thread                m_thread;           ///< the worker thread
+};
+
+inline bool IoCompletion::ready() const {
+    return !m_worker || m_worker->ready(m_ticket);
+}
+
+inline bool IoCompletion::wait() const {
+    return m_worker && m_worker->wait(m_ticket);
+}
+
+}  // namespace daq
+}  // namespace mahi
@@ -19,7 +19,16 @@
 #include <Mahi/Util/Event.hpp>
 #include <Mahi/Util/NonCopyable.hpp>
 #include <Mahi/Daq/Module.hpp>
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Snapshot.hpp>
+#include <Mahi/Daq/Trace.hpp>
+#include <algorithm>
+#include <cstring>
 #include <functional>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace mahi {
 namespace daq {
@@ -27,6 +36,34 @@ namespace daq {
 using util::Event;
 using util::CollectorBooleanAnd;
 
+/// An Event for post-read and post-write stages that remembers whether a slot was ever
+/// connected, so that emitting it costs a single branch on the common path where none is
+template <typename Sig>
+class StageEvent;
+
+template <typename... A>
+class StageEvent<void(A...)> : public Event<void(A...)> {
+public:
+    /// Constructor
+    StageEvent(std::nullptr_t = nullptr) : m_connected(false) {}
+    /// Connects a slot (see util::Event::connect)
+    template <typename... F>
+    auto connect(F&&... f) -> decltype(std::declval<Event<void(A...)>&>().connect(std::forward<F>(f)...)) {
+        m_connected = true;
+        return Event<void(A...)>::connect(std::forward<F>(f)...);
+    }
+    /// Calls the connected slots, if any were ever connected
+    void emit(A... a) {
+        if (m_connected)
+            Event<void(A...)>::emit(a...);
+    }
+    /// Returns true once a slot has been connected
+    bool connected() const { return m_connected; }
+
+private:
+    bool m_connected;  ///< true once a slot has been connected
+};
+
 /// Base class for Module array types
 class BufferBase : util::NonCopyable {
 public:
@@ -39,16 +76,36 @@ protected:
     friend ChanneledModule;
     /// Called by Module when channel numbers change
     virtual void remap(const ChanMap& old_map, const ChanMap& new_map) = 0;
+    /// Called by Module to create or destroy this Buffer's Snapshot
+    virtual void enable_snapshot(bool enable) = 0;
+    /// Called by Module to publish this Buffer's current values to its Snapshot
+    virtual void publish_snapshot(std::uint64_t cycle) = 0;
+    friend ProcessImage;
+    friend DaqServer;
+    /// Returns the address of the first value (used by ProcessImage and DaqServer)
+    virtual const void* raw_data() const = 0;
+    /// Returns the address of the first value for writing (used by DaqServer)
+    virtual void* raw_data() = 0;
+    /// Returns the size of all values in bytes
+    virtual std::size_t raw_size() const = 0;
+    /// Returns the alignment of a single value in bytes
+    virtual std::size_t raw_align() const = 0;
+    /// Returns the type of a single value
+    virtual TraceType raw_type() const = 0;
     /// Returns internal channel number
     inline ChanNum intern(ChanNum public_facing) {
         return m_module.convert_channel(public_facing);
     }
-    /// Returns buffer index associated with channel number.
+    /// Returns buffer index associated with channel number (which must be valid).
     inline std::size_t index(ChanNum channel_number) const {
-        return m_module.m_ch_map.at(channel_number);
+        return m_module.m_ch_map[channel_number];
     }
     /// Checks if a channel number is a number currently maintained on this Module.
-    bool valid_channel(ChanNum ch, bool quiet = false) const;
+    inline bool valid_channel(ChanNum ch, bool quiet = false) const {
+        return m_module.m_ch_map.find(ch) != ChanMap::npos || invalid_channel(ch, quiet);
+    }
+    /// Logs an invalid channel number (unless quiet) and returns false
+    bool invalid_channel(ChanNum ch, bool quiet) const;
     /// Checks if #size equals the number of maintained channels.
     bool valid_count(std::size_t size, bool quiet = false) const;
 private:
@@ -67,6 +124,14 @@ public:
     /// Overload stream operator
     template <typename U>
     friend std::ostream& operator<<(std::ostream& os, const Buffer<U>& buf);
+    /// Thread safe, lock-free retrieval of the values last published after a successful read
+    /// (see ChanneledModule::enable_snapshots). Values are in the same order as channels().
+    /// Optionally returns the Module's publish cycle, which can be used to match snapshots
+    /// of different Buffers on the same Module. Returns false if snapshots are not enabled
+    /// or nothing has been published yet.
+    bool snapshot(BufferType& values, std::uint64_t* cycle = nullptr) const {
+        return m_snapshot ? m_snapshot->fetch(values, cycle) : false;
+    }
 
 protected:
     /// Returns a constant reference to the entire internal buffer
@@ -78,13 +143,47 @@ protected:
     /// Returns a non-const reference to buffer element index by channel number (read access)
     T& buffer(ChanNum ch) { return m_buffer[index(ch)]; }
 
-private:
+protected:
     /// Called by parent Module when its channel numbers change
     void remap(const ChanMap& old_map, const ChanMap& new_map) override;
 
 private:
-    BufferType m_buffer;   ///< raw buffer
-    T          m_default;  ///< default value
+    /// Called by parent Module to create or destroy the Snapshot
+    void enable_snapshot(bool enable) override;
+    /// Called by parent Module to publish the Snapshot
+    void publish_snapshot(std::uint64_t cycle) override;
+    /// Returns the address of the first value
+    const void* raw_data() const override { return m_buffer.data(); }
+    /// Returns the address of the first value for writing
+    void* raw_data() override { return m_buffer.data(); }
+    /// Returns the size of all values in bytes
+    std::size_t raw_size() const override { return m_buffer.size() * sizeof(T); }
+    /// Returns the alignment of a single value in bytes
+    std::size_t raw_align() const override { return alignof(T); }
+    /// Returns the type of a single value
+    TraceType raw_type() const override { return trace_type<T>(); }
+
+private:
+    BufferType                   m_buffer;    ///< raw buffer
+    T                            m_default;   ///< default value
+    std::unique_ptr<Snapshot<T>> m_snapshot;  ///< published copy of m_buffer (nullptr if disabled)
+};
+
+/// A bool that invalidates its Daq's cycle plan when its value changes (see Daq::invalidate_plan)
+class CycleFlag {
+public:
+    /// Constructor
+    CycleFlag(Daq& daq, bool value) : m_daq(daq), m_value(value) {}
+    /// Sets the flag, invalidating the Daq's cycle plan if the value changed
+    CycleFlag& operator=(bool value);
+    /// Sets the flag from another flag's value
+    CycleFlag& operator=(const CycleFlag& other) { return *this = static_cast<bool>(other); }
+    /// Returns the flag value
+    operator bool() const { return m_value; }
+
+private:
+    Daq& m_daq;    ///< the Daq whose plan depends on this flag
+    bool m_value;  ///< the flag value
 };
 
 /// Flags a Buffer as a Readable, i.e. one that physically reads from the DAQ
@@ -94,8 +193,31 @@ public:
     Readable(ChanneledModule& module);
     /// Read implementation that will be called from a read_all
     virtual bool read() = 0;
+    /// Starts read on the Daq's I/O worker and returns immediately. Do not touch this Buffer
+    /// until the handle is waited on. The Daq must be open. See Daq::enable_async_io.
+    IoCompletion read_async();
     /// If true, read will be called when a read_all call is made
-    bool read_with_all;
+    CycleFlag read_with_all;
+
+protected:
+    friend Daq;
+    /// Resolves the step that read_all will execute for this Readable.
+    /// Returns false if there is nothing to read (i.e. no channels).
+    virtual bool plan_read(CycleStep& step) = 0;
+    /// Resolves the steps of a pipelined read_all (see Daq::set_pipelined): transfer reads
+    /// into staging storage on the I/O worker, and finish copies it into the buffer and runs
+    /// the post-read stages. Returns false if there is nothing to read.
+    virtual bool plan_pipelined_read(CycleStep& transfer, CycleStep& finish) = 0;
+    friend TraceWriter;
+    /// Logs every successful physical read to writer, or stops logging if writer is nullptr
+    virtual void trace_read(TraceWriter* writer) = 0;
+    /// Waits for the Daq's pipelined transfer or asynchronous operation in progress and
+    /// discards those queued. IRead's destructor calls this, before the storage they read
+    /// into is destroyed.
+    void abandon_io();
+
+private:
+    Daq& m_daq;  ///< the Daq whose I/O worker runs read_async
 };
 
 /// Flags a Buffer as a Writeable, i.e. one that physically writes to the DAQ
@@ -105,8 +227,31 @@ public:
     Writeable(ChanneledModule& module);
     /// Write implementation that will be called from a write_all
     virtual bool write() = 0;
+    /// Starts write on the Daq's I/O worker and returns immediately. Do not touch this Buffer
+    /// until the handle is waited on. The Daq must be open. See Daq::enable_async_io.
+    IoCompletion write_async();
     /// If true, write will be called when a write_all call is made
-    bool write_with_all;
+    CycleFlag write_with_all;
+
+protected:
+    friend Daq;
+    /// Resolves the step that write_all will execute for this Writeable.
+    /// Returns false if there is nothing to write (i.e. no channels).
+    virtual bool plan_write(CycleStep& step) = 0;
+    /// Resolves the steps of a pipelined write_all (see Daq::set_pipelined): stage copies the
+    /// buffer into staging storage, transfer writes it on the I/O worker, and finish runs the
+    /// post-write stages. Returns false if there is nothing to write.
+    virtual bool plan_pipelined_write(CycleStep& stage, CycleStep& transfer, CycleStep& finish) = 0;
+    friend TraceWriter;
+    /// Logs every successful physical write to writer, or stops logging if writer is nullptr
+    virtual void trace_write(TraceWriter* writer) = 0;
+    /// Waits for the Daq's pipelined transfer or asynchronous operation in progress and
+    /// discards those queued. IWrite's destructor calls this, before the storage they write
+    /// from is destroyed.
+    void abandon_io();
+
+private:
+    Daq& m_daq;  ///< the Daq whose I/O worker runs write_async
 };
 
 //==============================================================================
@@ -149,10 +294,14 @@ public:
     /// Buffer write access with operator[] (does NOT validate channel number, invalid numbers will
     /// cause undefined behavior)
     typename Base::Type& operator[](ChanNum ch) { return this->buffer(ch); }
-    /// Set all buffer values at once (does size check)
-    void set(const typename Base::BufferType& values) {
-        if (this->valid_count(values.size()))
-            this->buffer() = values;
+    /// Buffer write access by buffer index (see ChanneledModule::channel_index), skipping the
+    /// channel lookup (does NOT validate the index)
+    typename Base::Type& at_index(std::size_t i) { return this->buffer()[i]; }
+    /// Set all buffer values at once (does size check). Accepts a std::vector, a braced
+    /// list, or Span(pointer, count).
+    void set(Span<typename Base::Type> values) {
+        if (this->valid_count(values.size()) && values.data() != this->buffer().data())
+            std::copy(values.begin(), values.end(), this->buffer().begin());
     }
     /// Sets a single channel. The channel must be valid.
     bool set(ChanNum ch, typename Base::Type value) {
@@ -164,14 +313,14 @@ public:
     }
     /// Sets a subset of channels. The channels and values passed must have the same size,
     /// and all channel numbers must be valid.
-    bool set(const ChanNums& chs, const typename Base::BufferType& values) {
+    bool set(Span<ChanNum> chs, Span<typename Base::Type> values) {
         if (chs.size() != values.size())
             return false;
         for (auto& ch : chs) {
             if (!this->valid_channel(ch))
                 return false;
         }
-        for (int i = 0; i < chs.size(); ++i)
+        for (std::size_t i = 0; i < chs.size(); ++i)
             this->buffer(chs[i]) = values[i];
         return true;
     }
@@ -183,27 +332,86 @@ class IRead : public Base, public Readable {
 public:
     /// Constructor
     IRead(ChanneledModule& module, typename Base::Type default_value)
-        : Base(module, default_value), Readable(module), on_read(nullptr), post_read(nullptr) {}
+        : Base(module, default_value), Readable(module), on_read(nullptr), post_read(nullptr),
+          m_read(&IRead::emit_read), m_read_step(&IRead::invoke_read),
+          m_trace(nullptr), m_trace_stream(0), m_trace_connected(false) {}
+    /// Destructor. Modules are members of their Daq, so the first Buffer destroyed waits out
+    /// any pipelined transfer or asynchronous I/O still using the Daq's Buffers, whatever the
+    /// Daq subclass.
+    ~IRead() { Readable::abandon_io(); }
     /// Immediately reads values into the software buffer.
     /// Returns true for success, false otherwise. Overrides Readable::read.
     virtual bool read() override {
-        if (on_read.emit(&this->module().channels_internal()[0], &this->buffer()[0],
-                         this->module().channels_internal().size())) {
-            post_read.emit(&this->module().channels_internal()[0], &this->buffer()[0],
+        return m_read_step(this, &this->module().channels_internal()[0], &this->buffer()[0],
                            this->module().channels_internal().size());
-            return true;
-        }
-        return false;
     }
     /// Immediately reads a single channel into the software buffer.
     /// Returns true for success, false otherwise.
     bool read(ChanNum ch) {
         ChanNum intern_ch = this->intern(ch);
-        if (this->valid_channel(ch) && on_read.emit(&intern_ch, &this->buffer(ch), 1)) {
-            post_read.emit(&intern_ch, &this->buffer(ch), 1);
-            return true;
+        return this->valid_channel(ch) && m_read_step(this, &intern_ch, &this->buffer(ch), 1);
+    }
+    /// Immediately reads a subset of channels into the software buffer, with one physical read
+    /// per 64 channels. The channel numbers must be valid. Returns true for success, false otherwise.
+    bool read(Span<ChanNum> chs) {
+        for (std::size_t i = 0; i < chs.size(); ++i) {
+            if (!this->valid_channel(chs[i]))
+                return false;
+        }
+        for (std::size_t first = 0; first < chs.size(); first += 64) {
+            std::size_t         n = chs.size() - first > 64 ? 64 : chs.size() - first;
+            ChanNum             intern_chs[64];
+            typename Base::Type values[64];
+            for (std::size_t i = 0; i < n; ++i)
+                intern_chs[i] = this->intern(chs[first + i]);
+            if (!m_read(this, intern_chs, values, n))
+                return false;
+            for (std::size_t i = 0; i < n; ++i)
+                this->buffer(chs[first + i]) = values[i];
+            post_read.emit(intern_chs, values, n);
+        }
+        if (chs.size() > 0)
+            this->module().publish_snapshots();
+        return true;
+    }
+
+protected:
+    /// Resolves the channel/buffer/count triple for the Daq's cycle plan. Overrides Readable::plan_read.
+    virtual bool plan_read(CycleStep& step) override {
+        if (this->module().channels_internal().size() == 0)
+            return false;
+        step.invoke = m_read_step;
+        step.target = this;
+        step.chs    = &this->module().channels_internal()[0];
+        step.values = &this->buffer()[0];
+        step.n      = this->module().channels_internal().size();
+        return true;
+    }
+    /// Resolves the steps of a pipelined read_all. Overrides Readable::plan_pipelined_read.
+    virtual bool plan_pipelined_read(CycleStep& transfer, CycleStep& finish) override {
+        if (!plan_read(transfer))
+            return false;
+        m_staged.resize(transfer.n);
+        transfer.invoke = &IRead::transfer_read;
+        transfer.values = &m_staged[0];
+        finish          = transfer;
+        finish.invoke   = &IRead::finish_read;
+        return true;
+    }
+    /// Logs post_read payloads to writer. Overrides Readable::trace_read.
+    virtual void trace_read(TraceWriter* writer) override {
+        m_trace = writer;
+        if (!writer)
+            return;
+        m_trace_stream = writer->add_stream(this->module(), false, trace_type<typename Base::Type>(),
+                                            sizeof(typename Base::Type));
+        if (!m_trace_connected) {
+            post_read.connect([this](const ChanNum* chs, const typename Base::Type* values, std::size_t n) {
+                if (m_trace)
+                    m_trace->log(m_trace_stream, chs, values, n);
+            });
+            m_trace_connected = true;
         }
-        return false;
     }
 
 protected:
@@ -215,7 +423,77 @@ protected:
     /// Connect to this Event if you need to update other values after a successful read.
     /// The channel numbers passed will be the internal representation (see
     /// Module::transform_channels).
-    Event<void(const ChanNum*, const typename Base::Type*, std::size_t)> post_read;
+    StageEvent<void(const ChanNum*, const typename Base::Type*, std::size_t)> post_read;
+    /// Replaces on_read with member function F of Module M, bound at compile time so that
+    /// it can be inlined into read and the Daq cycle plan (see ChanneledModule::bind_read).
+    template <typename M, bool (M::*F)(const ChanNum*, typename Base::Type*, std::size_t)>
+    void set_read_impl() {
+        m_read      = &IRead::call_bound<M, F>;
+        m_read_step = &IRead::invoke_bound<M, F>;
+        this->module().daq().invalidate_plan();
+    }
+
+private:
+    /// Signature of the functions that perform the physical read
+    typedef bool (*ReadImpl)(IRead*, const ChanNum*, typename Base::Type*, std::size_t);
+    /// Performs the physical read with on_read
+    static bool emit_read(IRead* self, const ChanNum* chs, typename Base::Type* values, std::size_t n) {
+        LatencyTimer timer(self->module().read_latency());
+        return self->on_read.emit(chs, values, n);
+    }
+    /// Performs the physical read with a bound member function
+    template <typename M, bool (M::*F)(const ChanNum*, typename Base::Type*, std::size_t)>
+    static bool call_bound(IRead* self, const ChanNum* chs, typename Base::Type* values, std::size_t n) {
+        LatencyTimer timer(self->module().read_latency());
+        return (static_cast<M&>(self->module()).*F)(chs, values, n);
+    }
+    /// Trampoline called by read and the Daq cycle plan when on_read is used
+    static bool invoke_read(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IRead* self = static_cast<IRead*>(target);
+        auto   vals = static_cast<typename Base::Type*>(values);
+        LatencyTimer timer(self->module().read_latency());
+        if (self->on_read.emit(chs, vals, n)) {
+            self->post_read.emit(chs, vals, n);
+            self->module().publish_snapshots();
+            return true;
+        }
+        return false;
+    }
+    /// Trampoline called by read and the Daq cycle plan when a member function is bound
+    template <typename M, bool (M::*F)(const ChanNum*, typename Base::Type*, std::size_t)>
+    static bool invoke_bound(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IRead* self = static_cast<IRead*>(target);
+        auto   vals = static_cast<typename Base::Type*>(values);
+        LatencyTimer timer(self->module().read_latency());
+        if ((static_cast<M&>(self->module()).*F)(chs, vals, n)) {
+            self->post_read.emit(chs, vals, n);
+            self->module().publish_snapshots();
+            return true;
+        }
+        return false;
+    }
+    /// Pipelined step run on the I/O worker: physically reads into the staging storage
+    static bool transfer_read(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IRead* self = static_cast<IRead*>(target);
+        return self->m_read(self, chs, static_cast<typename Base::Type*>(values), n);
+    }
+    /// Pipelined step run by read_all: publishes the staged values and runs the post-read stages
+    static bool finish_read(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IRead* self   = static_cast<IRead*>(target);
+        auto   staged = static_cast<const typename Base::Type*>(values);
+        std::copy(staged, staged + n, self->buffer().begin());
+        self->post_read.emit(chs, &self->buffer()[0], n);
+        self->module().publish_snapshots();
+        return true;
+    }
+
+private:
+    ReadImpl          m_read;       ///< emit_read, or call_bound if a member function is bound
+    CycleStep::Invoke m_read_step;  ///< invoke_read, or invoke_bound if a member function is bound
+    std::vector<typename Base::Type> m_staged;  ///< values read by a pipelined read_all
+    TraceWriter*      m_trace;            ///< the TraceWriter logging reads (nullptr if none)
+    std::uint32_t     m_trace_stream;     ///< this Buffer's stream in m_trace
+    bool              m_trace_connected;  ///< true once the trace slot is connected to post_read
 };
 
 /// Mixin this to inject an immediate write interface into a Buffer<T> (see Io.hpp for examples)
@@ -224,25 +502,54 @@ class IWrite : public Base, public Writeable {
 public:
     /// Constructor
     IWrite(ChanneledModule& module, typename Base::Type default_value)
-        : Base(module, default_value), Writeable(module), on_write(nullptr) {}
-    /// Immediately writes the values currently stored in the software buffer.
-    /// Returns true for success, false otherwise. Overrides Writeable::write.
+        : Base(module, default_value), Writeable(module), on_write(nullptr),
+          m_write(&IWrite::emit_write), m_write_step(&IWrite::invoke_write),
+          m_change_only(false), m_stale(true), m_refresh(0), m_since_refresh(0), m_skipped(0),
+          m_trace(nullptr), m_trace_stream(0), m_trace_connected(false) {}
+    /// Destructor. Waits out any pipelined transfer or asynchronous I/O (see ~IRead).
+    ~IWrite() { Writeable::abandon_io(); }
+    /// Immediately writes the values currently stored in the software buffer (only those that
+    /// changed if change-only writes are enabled). Returns true for success, false otherwise.
+    /// Overrides Writeable::write.
     virtual bool write() override {
-        if (on_write.emit(&this->module().channels_internal()[0], &this->buffer()[0],
-                          this->module().channels_internal().size())) {
-            post_write.emit(&this->module().channels_internal()[0], &this->buffer()[0],
-                            this->module().channels_internal().size());
-            return true;
-        }
-        return false;
+        return (m_change_only ? &IWrite::invoke_changes : m_write_step)(this,
+            &this->module().channels_internal()[0], &this->buffer()[0], this->module().channels_internal().size());
     }
-    /// Immediately writes the passed vector. It's size must be equal to the number of channels.
-    /// Returns true for success, false otherwise.
-    bool write(const typename Base::BufferType& values) {
+    /// Enables or disables change-only writes. When enabled, write() and write_all only pass
+    /// the channels whose values changed since they were last written (by more than their
+    /// dead-band, see set_deadband) to on_write, and skip it entirely if none did. Every
+    /// refresh-th write (0 for never) and the first write after enabling or set_channels
+    /// write all channels, so hardware state cannot stay stale. Useful when each channel
+    /// costs a register or API call (e.g. DIO lines); pointless for single-transaction writes.
+    void set_change_only(bool enable, std::size_t refresh = 100) {
+        m_change_only = enable;
+        m_refresh     = refresh;
+        m_stale       = true;
+        this->module().daq().invalidate_plan();
+    }
+    /// Sets the dead-band of a channel for change-only writes: changes of at most deadband
+    /// from the last written value are not written. Applies to arithmetic value types only
+    /// (others are written whenever they change). The channel must be valid.
+    bool set_deadband(ChanNum ch, typename Base::Type deadband) {
+        if (!this->valid_channel(ch))
+            return false;
+        m_deadbands[ch] = deadband;
+        m_stale         = true;
+        return true;
+    }
+    /// Returns the number of channel writes skipped by change-only writes
+    std::uint64_t writes_skipped() const { return m_skipped; }
+    /// Immediately writes the passed values (a std::vector, a braced list, or Span(pointer,
+    /// count)). Its size must be equal to the number of channels. Returns true for success,
+    /// false otherwise.
+    bool write(Span<typename Base::Type> values) {
         if (this->valid_count(values.size()) &&
-            on_write.emit(&this->module().channels_internal()[0], &values[0],
-                          this->module().channels_internal().size())) {
-            this->buffer() = values;
+            m_write(this, &this->module().channels_internal()[0], values.data(),
+                    this->module().channels_internal().size())) {
+            if (values.data() != this->buffer().data())
+                std::copy(values.begin(), values.end(), this->buffer().begin());
+            if (m_last.size() == values.size())
+                std::copy(values.begin(), values.end(), m_last.begin());
             post_write.emit(&this->module().channels_internal()[0], &this->buffer()[0],
                             this->module().channels_internal().size());
             return true;
@@ -253,32 +560,86 @@ public:
     /// Returns true for success, false otherwise.
     bool write(ChanNum ch, typename Base::Type value) {
         ChanNum intern_ch = this->intern(ch);
-        if (this->valid_channel(ch) && on_write.emit(&intern_ch, &value, 1)) {
+        if (this->valid_channel(ch) && m_write(this, &intern_ch, &value, 1)) {
             this->buffer(ch) = value;
+            if (!m_last.empty())
+                m_last[this->index(ch)] = value;
             post_write.emit(&intern_ch, &this->buffer(ch), 1);
             return true;
         }
         return false;
     }
-    /// Immediately writes a subset of channels (up to 64). The channel numbers must be valid and
-    /// chs and values must be the same size. Returns true for success, false otherwise.
-    bool write(const ChanNums& chs, const typename Base::BufferType& values) {
+    /// Immediately writes a subset of channels, with one physical write per 64 channels. The
+    /// channel numbers must be valid and chs and values must be the same size. Returns true for
+    /// success, false otherwise.
+    bool write(Span<ChanNum> chs, Span<typename Base::Type> values) {
         if (chs.size() == 0 || values.size() == 0)
             return true;
-        std::size_t n = chs.size() > 64 ? 64 : chs.size();
-        ChanNum     intern_chs[64];
-        for (std::size_t i = 0; i < n; ++i) {
+        if (chs.size() != values.size())
+            return false;
+        for (std::size_t i = 0; i < chs.size(); ++i) {
             if (!this->valid_channel(chs[i]))
                 return false;
-            intern_chs[i] = this->intern(chs[i]);
         }
-        if (chs.size() == values.size() && on_write.emit(intern_chs, &values[0], n)) {
-            for (std::size_t i = 0; i < chs.size(); ++i)
+        for (std::size_t first = 0; first < chs.size(); first += 64) {
+            std::size_t n = chs.size() - first > 64 ? 64 : chs.size() - first;
+            ChanNum     intern_chs[64];
+            for (std::size_t i = 0; i < n; ++i)
+                intern_chs[i] = this->intern(chs[first + i]);
+            if (!m_write(this, intern_chs, values.data() + first, n))
+                return false;
+            for (std::size_t i = first; i < first + n; ++i) {
                 this->buffer(chs[i]) = values[i];
-            post_write.emit(intern_chs, &values[0], n);
-            return true;
+                if (!m_last.empty())
+                    m_last[this->index(chs[i])] = values[i];
+            }
+            post_write.emit(intern_chs, values.data() + first, n);
+        }
+        return true;
+    }
+
+protected:
+    /// Resolves the channel/buffer/count triple for the Daq's cycle plan. Overrides Writeable::plan_write.
+    virtual bool plan_write(CycleStep& step) override {
+        if (this->module().channels_internal().size() == 0)
+            return false;
+        step.invoke = m_change_only ? &IWrite::invoke_changes : m_write_step;
+        step.target = this;
+        step.chs    = &this->module().channels_internal()[0];
+        step.values = &this->buffer()[0];
+        step.n      = this->module().channels_internal().size();
+        return true;
+    }
+    /// Resolves the steps of a pipelined write_all. The staging storage is this Buffer's back
+    /// buffer, so values set with operator[] while it is being written never race the write.
+    /// Change-only writes are not applied. Overrides Writeable::plan_pipelined_write.
+    virtual bool plan_pipelined_write(CycleStep& stage, CycleStep& transfer, CycleStep& finish) override {
+        if (!plan_write(transfer))
+            return false;
+        m_staged.resize(transfer.n);
+        transfer.invoke = &IWrite::transfer_write;
+        transfer.values = &m_staged[0];
+        stage           = transfer;
+        stage.invoke    = &IWrite::stage_write;
+        finish          = transfer;
+        finish.invoke   = &IWrite::finish_write;
+        m_stale         = true;
+        return true;
+    }
+    /// Logs post_write payloads to writer. Overrides Writeable::trace_write.
+    virtual void trace_write(TraceWriter* writer) override {
+        m_trace = writer;
+        if (!writer)
+            return;
+        m_trace_stream = writer->add_stream(this->module(), true, trace_type<typename Base::Type>(),
+                                            sizeof(typename Base::Type));
+        if (!m_trace_connected) {
+            post_write.connect([this](const ChanNum* chs, const typename Base::Type* values, std::size_t n) {
+                if (m_trace)
+                    m_trace->log(m_trace_stream, chs, values, n);
+            });
+            m_trace_connected = true;
         }
-        return false;
     }
 
 protected:
@@ -290,7 +651,152 @@ protected:
     /// Connect to this Event if you need to update other values after a successful read
     /// The channel numbers passed will be the internal representation (see
     /// Module::convert_channel).
-    Event<void(const ChanNum*, const typename Base::Type*, std::size_t)> post_write;
+    StageEvent<void(const ChanNum*, const typename Base::Type*, std::size_t)> post_write;
+    /// Replaces on_write with member function F of Module M, bound at compile time so that
+    /// it can be inlined into write and the Daq cycle plan (see ChanneledModule::bind_write).
+    template <typename M, bool (M::*F)(const ChanNum*, const typename Base::Type*, std::size_t)>
+    void set_write_impl() {
+        m_write      = &IWrite::call_bound<M, F>;
+        m_write_step = &IWrite::invoke_bound<M, F>;
+        this->module().daq().invalidate_plan();
+    }
+    /// Forces a full write after channels change. Overrides Buffer::remap.
+    void remap(const ChanMap& old_map, const ChanMap& new_map) override {
+        Base::remap(old_map, new_map);
+        m_stale = true;
+    }
+
+private:
+    /// Signature of the functions that perform the physical write
+    typedef bool (*WriteImpl)(IWrite*, const ChanNum*, const typename Base::Type*, std::size_t);
+    /// Performs the physical write with on_write
+    static bool emit_write(IWrite* self, const ChanNum* chs, const typename Base::Type* values, std::size_t n) {
+        LatencyTimer timer(self->module().write_latency());
+        return self->on_write.emit(chs, values, n);
+    }
+    /// Performs the physical write with a bound member function
+    template <typename M, bool (M::*F)(const ChanNum*, const typename Base::Type*, std::size_t)>
+    static bool call_bound(IWrite* self, const ChanNum* chs, const typename Base::Type* values, std::size_t n) {
+        LatencyTimer timer(self->module().write_latency());
+        return (static_cast<M&>(self->module()).*F)(chs, values, n);
+    }
+    /// Trampoline called by write and the Daq cycle plan when on_write is used
+    static bool invoke_write(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        auto    vals = static_cast<const typename Base::Type*>(values);
+        LatencyTimer timer(self->module().write_latency());
+        if (self->on_write.emit(chs, vals, n)) {
+            self->post_write.emit(chs, vals, n);
+            return true;
+        }
+        return false;
+    }
+    /// Trampoline called by write and the Daq cycle plan when a member function is bound
+    template <typename M, bool (M::*F)(const ChanNum*, const typename Base::Type*, std::size_t)>
+    static bool invoke_bound(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        auto    vals = static_cast<const typename Base::Type*>(values);
+        LatencyTimer timer(self->module().write_latency());
+        if ((static_cast<M&>(self->module()).*F)(chs, vals, n)) {
+            self->post_write.emit(chs, vals, n);
+            return true;
+        }
+        return false;
+    }
+
+    /// Trampoline called by write and the Daq cycle plan when change-only writes are enabled.
+    /// Writes the changed subset of channels through m_write_step, or all of them when due.
+    static bool invoke_changes(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        auto    vals = static_cast<const typename Base::Type*>(values);
+        if (self->m_stale || self->m_last.size() != n)
+            self->reset_changes(n);
+        else if (self->m_refresh == 0 || ++self->m_since_refresh < self->m_refresh) {
+            std::size_t k = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (changed(vals[i], self->m_last[i], self->m_deadband[i], std::is_arithmetic<typename Base::Type>())) {
+                    self->m_dirty_idx[k]  = i;
+                    self->m_dirty_chs[k]  = chs[i];
+                    self->m_dirty_vals[k] = vals[i];
+                    ++k;
+                }
+            }
+            self->m_skipped += n - k;
+            if (k == 0)
+                return true;
+            if (!self->m_write_step(self, &self->m_dirty_chs[0], &self->m_dirty_vals[0], k))
+                return false;
+            for (std::size_t j = 0; j < k; ++j)
+                self->m_last[self->m_dirty_idx[j]] = self->m_dirty_vals[j];
+            return true;
+        }
+        // full refresh
+        self->m_since_refresh = 0;
+        if (!self->m_write_step(self, chs, values, n))
+            return false;
+        std::copy(vals, vals + n, self->m_last.begin());
+        self->m_stale = false;
+        return true;
+    }
+    /// Pipelined step run by write_all: copies the buffer into the staging storage
+    static bool stage_write(void* target, const ChanNum*, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        std::copy(self->buffer().begin(), self->buffer().begin() + n, static_cast<typename Base::Type*>(values));
+        return true;
+    }
+    /// Pipelined step run on the I/O worker: physically writes the staging storage
+    static bool transfer_write(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        return self->m_write(self, chs, static_cast<const typename Base::Type*>(values), n);
+    }
+    /// Pipelined step run by the next write_all once the write succeeded: runs the post-write stages
+    static bool finish_write(void* target, const ChanNum* chs, void* values, std::size_t n) {
+        IWrite* self = static_cast<IWrite*>(target);
+        self->post_write.emit(chs, static_cast<const typename Base::Type*>(values), n);
+        return true;
+    }
+    /// Sizes the change tracking storage for n channels and resolves the dead-bands
+    void reset_changes(std::size_t n) {
+        m_last.assign(n, typename Base::Type());
+        m_deadband.assign(n, typename Base::Type());
+        m_dirty_idx.resize(n);
+        m_dirty_chs.resize(n);
+        m_dirty_vals.resize(n);
+        for (std::size_t i = 0; i < n && i < this->module().channels().size(); ++i) {
+            auto it = m_deadbands.find(this->module().channels()[i]);
+            if (it != m_deadbands.end())
+                m_deadband[i] = it->second;
+        }
+    }
+    /// Returns true if an arithmetic value moved by more than deadband
+    template <typename U>
+    static bool changed(const U& value, const U& last, const U& deadband, std::true_type) {
+        return (value > last ? value - last : last - value) > deadband || value != value;
+    }
+    /// Returns true if any other value changed at all
+    template <typename U>
+    static bool changed(const U& value, const U& last, const U&, std::false_type) {
+        return std::memcmp(&value, &last, sizeof(U)) != 0;
+    }
+
+private:
+    WriteImpl         m_write;       ///< emit_write, or call_bound if a member function is bound
+    CycleStep::Invoke m_write_step;  ///< invoke_write, or invoke_bound if a member function is bound
+    bool              m_change_only;   ///< true if change-only writes are enabled
+    bool              m_stale;         ///< true if the next change-only write must write all channels
+    std::size_t       m_refresh;       ///< change-only writes between full refreshes (0 for never)
+    std::size_t       m_since_refresh; ///< change-only writes since the last full refresh
+    std::uint64_t     m_skipped;       ///< see writes_skipped
+    std::map<ChanNum, typename Base::Type> m_deadbands;   ///< dead-bands by channel number
+    std::vector<typename Base::Type>       m_last;        ///< last written values by buffer index
+    std::vector<typename Base::Type>       m_deadband;    ///< dead-bands by buffer index
+    std::vector<std::size_t>               m_dirty_idx;   ///< buffer indices of changed channels
+    std::vector<ChanNum>                   m_dirty_chs;   ///< internal channels of changed channels
+    std::vector<typename Base::Type>       m_dirty_vals;  ///< values of changed channels
+    std::vector<typename Base::Type>       m_staged;      ///< back buffer written by a pipelined write_all
+    TraceWriter*                           m_trace;            ///< the TraceWriter logging writes (nullptr if none)
+    std::uint32_t                          m_trace_stream;     ///< this Buffer's stream in m_trace
+    bool                                   m_trace_connected;  ///< true once the trace slot is connected to post_write
 };
 
 /// Exposes the protected members of Protected to Beneficiary
@@ -0,0 +1,136 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Metrics.hpp>
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Daq/Watchdog.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <atomic>
+#include <cstdint>
+
+namespace mahi {
+namespace daq {
+
+/// A fixed-rate read -> update -> write loop on the calling thread, with a measured timing
+/// discipline: each period it sleeps until shortly before the deadline and then spins, it
+/// handles overruns according to a policy, and it records how each cycle was spent.
+/// Override update, or use it directly to just cycle the Daq.
+///
+/// class MyLoop : public ControlLoop {
+/// public:
+///     MyLoop(Q8Usb& q8) : ControlLoop(q8, hertz(1000)) {}
+///     void update(Time t) override { ... if (done) stop(); }
+/// };
+/// MyLoop loop(q8);
+/// loop.run();  // returns after stop()
+class ControlLoop : util::NonCopyable {
+public:
+    /// What to do when a cycle finishes after the deadline of the next one
+    enum Overrun {
+        Skip,     ///< drop the missed periods and stay on the original schedule
+        CatchUp,  ///< run the missed cycles back to back until back on schedule
+        Log       ///< restart the schedule from now, and log how many cycles overran once run returns
+    };
+
+    /// ControlLoop configuration
+    struct Options {
+        /// Constructor
+        Options(Overrun overrun = Skip, const RealtimeOptions& realtime = RealtimeOptions(),
+                util::Time spin = util::microseconds(200), bool fused_io = false,
+                Watchdog* watchdog = nullptr) :
+            overrun(overrun), realtime(realtime), spin(spin), fused_io(fused_io), watchdog(watchdog) {}
+        Overrun         overrun;   ///< overrun policy
+        RealtimeOptions realtime;  ///< applied to the calling thread by run
+        util::Time      spin;      ///< how long before each deadline to stop sleeping and spin
+        bool            fused_io;  ///< if true, cycle write_read_all -> update instead of
+                                   ///< read_all -> update -> write_all (see Daq::write_read_all)
+        Watchdog*       watchdog;  ///< if set, kicked with Watchdog::kick_if_due after each cycle's
+                                   ///< writes; the loop stops if it fails or has expired. run sets
+                                   ///< its expiry check interval to the whole number of periods
+                                   ///< nearest below half its timeout (at least one).
+    };
+
+    /// Counters, safe to query from any thread
+    struct Stats {
+        std::uint64_t cycles;    ///< completed cycles
+        std::uint64_t misses;    ///< cycles that finished after their deadline
+        std::uint64_t skipped;   ///< periods dropped by the Skip policy
+        std::uint64_t failures;  ///< cycles in which the Daq I/O failed
+        util::Time    last_cycle;   ///< work time (I/O + update) of the last cycle
+        util::Time    max_cycle;    ///< longest work time seen
+        util::Time    max_overrun;  ///< longest time a cycle finished after its deadline
+    };
+
+    /// Constructor
+    ControlLoop(Daq& daq, util::Time period, const Options& options = Options());
+    /// Destructor
+    virtual ~ControlLoop() {}
+    /// Applies the real-time options to the calling thread, then cycles until stop is called,
+    /// and restores the thread's previous scheduling before returning. The Daq must be
+    /// enabled. Returns false if it was not, if the loop is already running, or if the
+    /// watchdog stopped the loop.
+    bool run();
+    /// Requests the loop to stop after the current cycle. A request made before run has
+    /// started cycling (e.g. from another thread, just after it called run) ends that run
+    /// before its first cycle; each run consumes the request when it returns. Safe to call
+    /// from any thread.
+    void stop();
+    /// Returns true while the loop is running
+    bool is_running() const;
+    /// Returns the cycle period
+    util::Time period() const;
+    /// Returns a copy of the counters
+    Stats stats() const;
+    /// Resets the counters and histograms
+    void reset_stats();
+    /// Time spent in Daq I/O per cycle (requires MAHI_DAQ_METRICS)
+    const LatencyHistogram& io_time() const { return m_io; }
+    /// Time spent in update per cycle (requires MAHI_DAQ_METRICS)
+    const LatencyHistogram& compute_time() const { return m_compute; }
+    /// Time spent waiting for the next deadline per cycle (requires MAHI_DAQ_METRICS)
+    const LatencyHistogram& idle_time() const { return m_idle; }
+    /// How late each cycle started relative to its deadline (requires MAHI_DAQ_METRICS)
+    const LatencyHistogram& lateness() const { return m_lateness; }
+
+protected:
+    /// Called every cycle with the time elapsed since run was called. Defaults to nothing.
+    virtual void update(util::Time t) {}
+    /// The Daq being cycled
+    Daq& daq;
+
+private:
+    util::Time                 m_period;    ///< cycle period
+    Options                    m_options;   ///< configuration
+    std::atomic<bool>          m_running;   ///< true from the start of run until it returns
+    std::atomic<bool>          m_stop;      ///< true once stop has been requested
+    std::atomic<std::uint64_t> m_cycles;    ///< see Stats
+    std::atomic<std::uint64_t> m_misses;    ///< see Stats
+    std::atomic<std::uint64_t> m_skipped;   ///< see Stats
+    std::atomic<std::uint64_t> m_failures;  ///< see Stats
+    std::atomic<std::int64_t>  m_last_us;     ///< see Stats
+    std::atomic<std::int64_t>  m_max_us;      ///< see Stats
+    std::atomic<std::int64_t>  m_max_over_us; ///< see Stats
+    LatencyHistogram           m_io;        ///< see io_time
+    LatencyHistogram           m_compute;   ///< see compute_time
+    LatencyHistogram           m_idle;      ///< see idle_time
+    LatencyHistogram           m_lateness;  ///< see lateness
+};
+
+}  // namespace daq
+}  // namespace mahi
@@ -17,7 +17,10 @@
 #pragma once
 
 #include <Mahi/Daq/Module.hpp>
+#include <Mahi/Daq/ProcessImage.hpp>
+#include <Mahi/Daq/AsyncIo.hpp>
 #include <Mahi/Util/Device.hpp>
+#include <memory>
 
 namespace mahi {
 namespace daq {
@@ -25,6 +28,21 @@ namespace daq {
 // Forward Declarations
 class Readable;
 class Writeable;
+class TraceWriter;
+class DaqServer;
+
+/// A single pre-resolved entry of a Daq's cycle plan. It holds everything needed to
+/// read or write one Buffer (its channel/buffer/count triple) so that read_all and
+/// write_all do not have to walk every Buffer and re-query its Module each cycle.
+struct CycleStep {
+    /// Type restoring trampoline into the Buffer's on_read or on_write Event
+    typedef bool (*Invoke)(void* target, const ChanNum* chs, void* values, std::size_t n);
+    Invoke         invoke;  ///< the trampoline to call
+    void*          target;  ///< the IRead/IWrite the step belongs to
+    const ChanNum* chs;     ///< the internal channel numbers
+    void*          values;  ///< the raw buffer values
+    std::size_t    n;       ///< the number of channels
+};
 
 /// A DAQ interface, the topmost level of the mahi::daq architecture
 class Daq : public util::Device {
@@ -37,8 +55,63 @@ public:
     virtual bool read_all();
     /// Reads all writeable ModuleInterfaces know to this DAQ if they allow it
     virtual bool write_all();
+    /// Writes all writeable Modules, then reads all readable Modules. Use this at the top of
+    /// a control cycle to send the outputs computed last cycle and sample new inputs. DAQs
+    /// that can do both in one transaction (e.g. QuanserDaq) override it, halving the I/O
+    /// round trips per cycle.
+    virtual bool write_read_all();
     /// Returns the number of modules on this DAQ
     const std::vector<Module*>& modules() const;
+    /// Forces the cycle plan used by read_all/write_all to be recompiled on its next use.
+    /// This is called automatically when Modules are added, when channels are set, and
+    /// when read_with_all/write_with_all change, so you should rarely need it.
+    void invalidate_plan();
+    /// Returns the histogram of read_all durations. Empty unless mahi::daq was built with
+    /// MAHI_DAQ_METRICS (see Metrics.hpp). Per-Module histograms are on ChanneledModule.
+    LatencyHistogram& read_all_latency() { return m_read_all_latency; }
+    /// Returns the histogram of read_all durations
+    const LatencyHistogram& read_all_latency() const { return m_read_all_latency; }
+    /// Returns the histogram of write_all durations. Empty unless mahi::daq was built with
+    /// MAHI_DAQ_METRICS (see Metrics.hpp).
+    LatencyHistogram& write_all_latency() { return m_write_all_latency; }
+    /// Returns the histogram of write_all durations
+    const LatencyHistogram& write_all_latency() const { return m_write_all_latency; }
+    /// Resets the read_all/write_all histograms and those of every ChanneledModule
+    void reset_latency();
+    /// Enables or disables the process image, a contiguous copy of every Buffer's values
+    /// refreshed by each successful read_all and write_all (see ProcessImage.hpp). Like
+    /// enable_snapshots, call this on startup. set_channels causes the image to be relaid.
+    void enable_process_image(bool enable = true);
+    /// Returns the process image, or nullptr if it is not enabled
+    const ProcessImage* process_image() const { return m_image.get(); }
+    /// Starts this Daq's I/O worker, the thread that runs read_all_async, write_all_async and
+    /// the read_async/write_async of its Buffers, with the given real-time settings. The first
+    /// asynchronous call starts it with default settings otherwise, so call this on startup.
+    void enable_async_io(const RealtimeOptions& options = RealtimeOptions());
+    /// Starts read_all on the I/O worker and returns immediately. Do not touch this Daq or
+    /// its Buffers (beyond those you know it does not read) until the handle is waited on.
+    /// Like all asynchronous I/O, it needs the Daq to be open; closing waits for it.
+    IoCompletion read_all_async();
+    /// Starts write_all on the I/O worker and returns immediately (see read_all_async)
+    IoCompletion write_all_async();
+    /// Enables or disables pipelined cycles. When enabled, read_all and write_all return as
+    /// soon as their data is handed over, and the physical transfers run on the I/O worker
+    /// while you compute: read_all publishes the inputs prefetched during the last cycle and
+    /// starts reading the next ones, and write_all copies the outputs into each Buffer's back
+    /// buffer and starts writing them (so operator[] may be used again immediately). A cycle
+    /// then takes as long as the slower of compute and I/O instead of their sum, but inputs
+    /// are one cycle older than usual: outputs written in cycle N are first read back in
+    /// cycle N + 2. write_all returns the result of the previous cycle's write, and post-write
+    /// stages run one cycle late. While enabled, use only read_all, write_all and
+    /// write_read_all on this Daq, and only while it is open. Setting channels drains the
+    /// pipeline first, as does closing, which Daq destructors do. DAQs with their own synced
+    /// transactions (e.g. QuanserDaq, RemoteDaq) keep using them, and are not pipelined.
+    void set_pipelined(bool enable);
+    /// Returns true if pipelined cycles are enabled
+    bool is_pipelined() const { return m_pipelined; }
+    /// Waits for the pipelined transfers in flight and discards any prefetched inputs. close,
+    /// disable, set_pipelined and ChanneledModule::set_channels call this.
+    void drain_pipeline();
 protected:
     /// Called when the DAQ opens
     virtual bool on_daq_open() { return true; }
@@ -48,12 +121,29 @@ protected:
     virtual bool on_daq_enable() { return true; }
     /// Called when the DAQ disables
     virtual bool on_daq_disable() { return true; }
+    /// Performs the physical reads or writes of a pipelined cycle on the I/O worker. The
+    /// default calls each step in turn; DAQs with synced I/O override it to make them one
+    /// transaction (e.g. SimDaq). State it uses besides the Buffers must be declared before
+    /// the Daq's Modules, so that it outlives them.
+    virtual bool transfer_all(const std::vector<CycleStep>& steps);
     /// Use this to facilitate pin sharing between ChannelsModules e.g. DIOs 
     /// commonly share pins with w/ PWM, I2C, encoders, etc.
     /// SharedPins({{{0},{0,1}},{{1,2},{2}}}) means Module a's channel 0
     /// shares with b's channels 0,1, and Modules a's channels 1,2 
     /// shares with b's channel 2.
     void create_shared_pins(ChanneledModule* a, ChanneledModule* b, SharedPins shares_pins);
+    /// Refreshes the input section of the process image if it is enabled. This is called by
+    /// read_all, but custom Daqs that read inputs themselves (e.g. QuanserDaq) should call it
+    /// after successful reads.
+    inline void capture_inputs() {
+        if (m_image)
+            capture_image(true);
+    }
+    /// Refreshes the output section of the process image if it is enabled (see capture_inputs)
+    inline void capture_outputs() {
+        if (m_image)
+            capture_image(false);
+    }
 private:
     /// Calls Daq::on_daq_open, then iteratively calls Module::on_daq_open 
     bool on_open() final;
@@ -63,6 +153,26 @@ private:
     bool on_enable() final;
     /// Iteratively calls Module::on_daq_enable , then Daq::on_daq_enable
     bool on_disable() final;
+    /// Collects the active Readables/Writeables into m_read_plan/m_write_plan
+    void compile_plan();
+    /// Relays the process image if needed, then captures its inputs or outputs
+    void capture_image(bool inputs);
+    /// Returns the I/O worker, starting it if needed
+    IoWorker& io_worker();
+    /// Pipelined read_all: publishes the prefetched inputs, then starts the next prefetch
+    bool read_pipelined();
+    /// Pipelined write_all: finishes the previous write, then stages and starts this one
+    bool write_pipelined();
+    /// Waits for the write in flight and runs its finish steps, returning its result
+    bool finish_pipelined_write();
+    /// Waits for the pipelined transfers and the asynchronous operation in progress without
+    /// publishing their results, and discards queued asynchronous operations. Called when the
+    /// first of this Daq's Buffers is destroyed, since they may use any of them.
+    void abandon_io();
+    /// I/O worker job performing the pipelined reads of the Daq daq
+    static bool transfer_reads(void* daq);
+    /// I/O worker job performing the pipelined writes of the Daq daq
+    static bool transfer_writes(void* daq);
 private:
     /// The Modules owned by this DAQ
     std::vector<Module*> m_modules;
@@ -73,6 +183,40 @@ private:
     /// The writeable ModuleInterfaces indirectly owned by this DAQ
     std::vector<Writeable*> m_writeables;
     friend Writeable;
+    friend TraceWriter;
+    friend DaqServer;
+    /// The compiled read steps executed by read_all
+    std::vector<CycleStep> m_read_plan;
+    /// The compiled write steps executed by write_all
+    std::vector<CycleStep> m_write_plan;
+    /// True if the plans need to be recompiled before they are next used
+    bool m_plan_dirty;
+    /// True if read_all and write_all are pipelined
+    bool m_pipelined;
+    /// The pipelined read transfers run on the I/O worker
+    std::vector<CycleStep> m_pipe_reads;
+    /// The steps publishing the pipelined reads
+    std::vector<CycleStep> m_pipe_read_finishes;
+    /// The steps staging the pipelined writes
+    std::vector<CycleStep> m_pipe_write_stages;
+    /// The pipelined write transfers run on the I/O worker
+    std::vector<CycleStep> m_pipe_writes;
+    /// The steps finishing the pipelined writes
+    std::vector<CycleStep> m_pipe_write_finishes;
+    /// The prefetch in flight (invalid if none)
+    IoCompletion m_pipe_reading;
+    /// The write in flight (invalid if none)
+    IoCompletion m_pipe_writing;
+    /// The process image (nullptr if disabled)
+    std::unique_ptr<ProcessImage> m_image;
+    /// True if the process image needs to be relaid before it is next captured
+    bool m_image_dirty;
+    /// The I/O worker (nullptr until asynchronous I/O is used)
+    std::unique_ptr<IoWorker> m_io;
+    /// Durations of read_all
+    LatencyHistogram m_read_all_latency;
+    /// Durations of write_all
+    LatencyHistogram m_write_all_latency;
 };
 
 } // namespace daq
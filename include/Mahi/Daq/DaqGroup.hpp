@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// Cycles several Daqs concurrently, so that a cycle over e.g. two Q8-USBs takes as long as
+/// the slowest device rather than the sum of both. The first Daq runs on the calling thread
+/// and every other Daq on its own worker thread; each call returns once all Daqs are done.
+/// Workers spin briefly between cycles, then sleep until the next one.
+///
+/// DaqGroup group({&q8a, &q8b}, {RealtimeOptions(), RealtimeOptions(2, 80)});
+/// while (...) {
+///     group.read_all();
+///     ...
+///     group.write_all();
+/// }
+///
+/// While a DaqGroup exists, only call into its Daqs through it (or when it is idle).
+class DaqGroup : util::NonCopyable {
+public:
+    /// Constructor. options[i] configures the worker thread of daqs[i] (see RealtimeOptions);
+    /// options[0] is ignored since daqs[0] runs on the calling thread.
+    DaqGroup(const std::vector<Daq*>& daqs,
+             const std::vector<RealtimeOptions>& options = std::vector<RealtimeOptions>());
+    /// Destructor. Stops the worker threads.
+    ~DaqGroup();
+    /// Calls read_all on every Daq concurrently. Returns true if all succeeded.
+    bool read_all();
+    /// Calls write_all on every Daq concurrently. Returns true if all succeeded.
+    bool write_all();
+    /// Calls write_read_all on every Daq concurrently. Returns true if all succeeded.
+    bool write_read_all();
+    /// Returns the Daqs in the group
+    const std::vector<Daq*>& daqs() const;
+    /// Returns true if daqs[i] succeeded in the last cycle
+    bool succeeded(std::size_t i) const;
+    /// Returns the number of cycles in which daqs[i] failed
+    std::uint64_t failures(std::size_t i) const;
+
+private:
+    /// The operation workers perform
+    enum Op { ReadAll, WriteAll, WriteReadAll };
+    /// A Daq's worker thread and its results
+    struct Worker {
+        std::thread                thread;    ///< the worker thread (none for daqs[0])
+        RealtimeOptions            options;   ///< applied to the worker thread
+        std::atomic<std::uint64_t> done;      ///< last cycle this worker finished
+        bool                       result;    ///< result of the last cycle
+        std::atomic<std::uint64_t> failures;  ///< see failures
+    };
+    /// Runs op on daqs[i]
+    bool execute(std::size_t i, Op op);
+    /// Runs op on every Daq and waits for all of them
+    bool cycle(Op op);
+    /// Worker thread entry point for daqs[i]
+    void run(std::size_t i);
+
+private:
+    std::vector<Daq*>                    m_daqs;      ///< the Daqs
+    std::vector<std::unique_ptr<Worker>> m_workers;   ///< one per Daq
+    alignas(64) std::atomic<std::uint64_t> m_cycle;   ///< incremented to start a cycle
+    std::atomic<int>                     m_op;        ///< the operation of the current cycle
+    std::atomic<bool>                    m_running;   ///< false to stop the workers
+    std::atomic<int>                     m_sleepers;  ///< workers waiting on m_wake
+    std::mutex                           m_mutex;     ///< guards m_wake
+    std::condition_variable              m_wake;      ///< wakes sleeping workers
+};
+
+}  // namespace daq
+}  // namespace mahi
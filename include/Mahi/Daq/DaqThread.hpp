@@ -0,0 +1,157 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+#include <Mahi/Daq/ControlLoop.hpp>
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Daq/SpscQueue.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+namespace mahi {
+namespace daq {
+
+/// Runs a Daq's read_all -> update -> write_all cycle at a fixed rate on a
+/// dedicated thread (a ControlLoop, see ControlLoop.hpp), isolating DAQ I/O from application jitter. While running,
+/// only the acquisition thread may touch the Daq and its Buffers. Use QueuedDaqThread to
+/// move data to and from your application through wait-free queues, or use Buffer
+/// snapshots (see ChanneledModule::enable_snapshots).
+///
+/// DaqThread thread(q8, hertz(1000));
+/// thread.update = [&](Time t) { q8.AO[0] = controller(q8.AI[0]); };
+/// thread.start();
+class DaqThread : util::NonCopyable {
+public:
+    /// Per-cycle timing statistics, safe to query from any thread
+    struct Stats {
+        std::uint64_t cycles;       ///< number of completed cycles
+        std::uint64_t overruns;     ///< number of cycles that finished after their deadline
+        std::uint64_t io_failures;  ///< number of cycles in which read_all or write_all failed
+        util::Time    last_cycle;   ///< work time (read + update + write) of the last cycle
+        util::Time    max_cycle;    ///< longest work time seen
+        util::Time    max_overrun;  ///< longest amount of time a cycle finished after its deadline
+    };
+
+    /// Constructor
+    DaqThread(Daq& daq, util::Time period, const RealtimeOptions& options = RealtimeOptions());
+    /// Destructor. Stops the thread if running.
+    ~DaqThread();
+    /// Starts the acquisition thread. Returns false if it is already running or the Daq is
+    /// not enabled.
+    bool start();
+    /// Requests the acquisition thread to stop and waits for it to finish.
+    void stop();
+    /// Returns true if the acquisition thread is running
+    bool is_running() const;
+    /// Returns the cycle period
+    util::Time period() const;
+    /// Returns a copy of the current statistics
+    Stats stats() const;
+    /// Resets the statistics
+    void reset_stats();
+
+    /// Called on the acquisition thread every cycle between read_all and write_all with
+    /// the time elapsed since start. Set this before calling start.
+    std::function<void(util::Time)> update;
+
+protected:
+    /// Called on the acquisition thread every cycle between read_all and write_all. Calls
+    /// update by default.
+    virtual void cycle(util::Time t);
+
+private:
+    /// The ControlLoop run by the acquisition thread, forwarding to update
+    class Loop : public ControlLoop {
+    public:
+        /// Constructor
+        Loop(DaqThread& owner, Daq& daq, util::Time period, const RealtimeOptions& options);
+    protected:
+        /// Calls the owner's cycle
+        void update(util::Time t) override;
+    private:
+        DaqThread& m_owner;  ///< the DaqThread owning this Loop
+    };
+    /// Acquisition thread entry point
+    void run();
+
+private:
+    Daq&              m_daq;      ///< the Daq being cycled
+    Loop              m_loop;     ///< the loop run by the acquisition thread
+    std::thread       m_thread;   ///< the acquisition thread
+    std::atomic<bool> m_running;  ///< true from start until the loop returns
+};
+
+/// A DaqThread that exchanges data with the application through its own wait-free
+/// SpscQueues. Every cycle, after read_all, it pushes sample(t) to #inputs (counting it as
+/// dropped if the application has let the queue fill up); then it runs update, and passes
+/// every value queued in #outputs to apply, in order, before write_all. Only the
+/// application thread may pop inputs and push outputs.
+///
+/// QueuedDaqThread<double, double> thread(q8, hertz(1000), 1024);
+/// thread.sample = [&](Time t) { return q8.AI[0]; };
+/// thread.apply  = [&](const double& v) { q8.AO[0] = v; };
+/// thread.start();
+/// ...                                   // on the application thread:
+/// while (thread.inputs.pop(ai)) { ... }
+/// thread.outputs.push(u);
+template <typename In, typename Out>
+class QueuedDaqThread : public DaqThread {
+public:
+    /// Constructor. Each queue holds up to capacity values.
+    QueuedDaqThread(Daq& daq, util::Time period, std::size_t capacity, const RealtimeOptions& options = RealtimeOptions()) :
+        DaqThread(daq, period, options), inputs(capacity), outputs(capacity), m_dropped(0) {}
+    /// Destructor. Stops the thread before the queues are destroyed.
+    ~QueuedDaqThread() { stop(); }
+    /// Returns the number of inputs dropped because #inputs was full
+    std::uint64_t inputs_dropped() const { return m_dropped; }
+
+    /// Called on the acquisition thread after each read_all to make the value pushed to
+    /// #inputs. Set this before calling start; if unset, nothing is pushed.
+    std::function<In(util::Time)> sample;
+    /// Called on the acquisition thread before each write_all with each value popped from
+    /// #outputs. Set this before calling start; if unset, outputs are discarded.
+    std::function<void(const Out&)> apply;
+    /// Acquisition thread -> application
+    SpscQueue<In> inputs;
+    /// Application -> acquisition thread
+    SpscQueue<Out> outputs;
+
+protected:
+    /// Pushes the sample, runs update, then applies the queued outputs
+    void cycle(util::Time t) override {
+        if (sample && !inputs.push(sample(t)))
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        DaqThread::cycle(t);
+        Out* out;
+        while ((out = outputs.front()) != nullptr) {
+            if (apply)
+                apply(*out);
+            outputs.pop();
+        }
+    }
+
+private:
+    std::atomic<std::uint64_t> m_dropped;  ///< see inputs_dropped
+};
+
+}  // namespace daq
+}  // namespace mahi
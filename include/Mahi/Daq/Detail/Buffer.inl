@@ -57,11 +57,27 @@ template <typename T>
 void Buffer<T>::remap(const ChanMap& old_map, const ChanMap& new_map)
 {
     std::vector<T> new_values(new_map.size(), m_default);
-    for (auto it = old_map.begin(); it != old_map.end(); ++it) {
-        if (new_map.count(it->first))
-            new_values[new_map.at(it->first)] = m_buffer[old_map.at(it->first)];
+    for (std::size_t i = 0; i < old_map.size(); ++i) {
+        std::size_t j = new_map.find(old_map.channels()[i]);
+        if (j != ChanMap::npos)
+            new_values[j] = m_buffer[i];
     }
     m_buffer = new_values;
+    if (m_snapshot)
+        m_snapshot->resize(m_buffer.size());
+}
+
+template <typename T>
+void Buffer<T>::enable_snapshot(bool enable) {
+    if (enable && !m_snapshot)
+        m_snapshot.reset(new Snapshot<T>(m_buffer.size()));
+    else if (!enable)
+        m_snapshot.reset();
+}
+
+template <typename T>
+void Buffer<T>::publish_snapshot(std::uint64_t cycle) {
+    m_snapshot->publish(m_buffer.data(), m_buffer.size(), cycle);
 }
 
 //==============================================================================
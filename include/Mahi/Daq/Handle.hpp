@@ -16,6 +16,7 @@
 
 #pragma once
 #include <Mahi/Daq/Io.hpp>
+#include <algorithm>
 
 namespace mahi {
 namespace daq {
@@ -40,8 +41,33 @@ namespace daq {
 //     daq.write_all(); // or daq.AO.write()
 // }
 //
+// If you do need to physically read/write a few channels on their own (e.g. those
+// of one robot joint), add their Handles to a HandleGroup (see below), which
+// batches them into one call per Module.
+//
 // Feel free to extended these classes to add additional functionality!
 
+/// Caches the buffer index of a Module channel until the Module's channels change (see
+/// ChanneledModule::generation), so that steady-state Handle access is a load and a compare
+/// instead of validating and looking up the channel every time.
+class ChannelCache {
+public:
+    /// Constructor
+    ChannelCache() : m_generation(0), m_index(ChanMap::npos) {}
+    /// Returns the buffer index of channel ch on mod, or ChanMap::npos if it is not maintained
+    inline std::size_t index(const ChanneledModule& mod, ChanNum ch) const {
+        if (m_generation != mod.generation()) {
+            m_index      = mod.channel_index(ch);
+            m_generation = mod.generation();
+        }
+        return m_index;
+    }
+
+private:
+    mutable std::uint64_t m_generation;  ///< generation m_index was resolved in (0 = never)
+    mutable std::size_t   m_index;       ///< resolved buffer index
+};
+
 /// A single-channel view into an AIModule
 class AIHandle {
 public:
@@ -49,16 +75,24 @@ public:
     AIHandle() {}
     /// Constructor
     AIHandle(AIModule& mod, ChanNum ch) : m_mod(&mod), m_ch(ch) {}
+    /// Returns the Module this Handle views.
+    inline AIModule& module() const { return *m_mod; }
+    /// Returns the channel number this Handle views.
+    inline ChanNum channel() const { return m_ch; }
     /// Physically reads the voltage into the software buffer.
     inline bool read() { return m_mod->read(m_ch); }
     /// Physically reads the voltage into the software buffer and returns the value.
     inline Volts read_volts() { return read() ? get_volts() : 0; }
     /// Returns the current value in the software buffer.
-    inline Volts get_volts() { return m_mod->get(m_ch); }
+    inline Volts get_volts() {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->get()[i] : m_mod->get(m_ch);
+    }
 
 protected:
-    AIModule* m_mod;
-    ChanNum   m_ch;
+    AIModule*    m_mod;
+    ChanNum      m_ch;
+    ChannelCache m_cache;
 };
 
 /// A single-channel view into a DIModule
@@ -68,20 +102,28 @@ public:
     DIHandle() {}
     /// Constructor
     DIHandle(DIModule& mod, ChanNum ch) : m_mod(&mod), m_ch(ch) {}
+    /// Returns the Module this Handle views.
+    inline DIModule& module() const { return *m_mod; }
+    /// Returns the channel number this Handle views.
+    inline ChanNum channel() const { return m_ch; }
     /// Physically reads the TTL level into the software buffer.
     inline bool read() { return m_mod->read(m_ch); }
     /// Physically reads the TTL level into the software buffer and returns the value.
     inline TTL read_level() { return read() ? get_level() : TTL_ERROR; }
     /// Returns the current value in the software buffer.
-    inline TTL get_level() { return m_mod->get(m_ch); }
+    inline TTL get_level() {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->get()[i] : m_mod->get(m_ch);
+    }
     /// Returns true if the current software buffer value is TTL_LOW.
     inline bool is_low() { return get_level() == TTL_LOW; }
     /// Returns true if the current sofware buffer value is TTL_HIGH.
     inline bool is_high() { return get_level() == TTL_HIGH; }
 
 protected:
-    DIModule* m_mod;
-    ChanNum   m_ch;
+    DIModule*    m_mod;
+    ChanNum      m_ch;
+    ChannelCache m_cache;
 };
 
 /// A single-channel view into an AOModule
@@ -91,22 +133,36 @@ public:
     AOHandle() {}
     /// Constructor
     AOHandle(AOModule& mod, ChanNum ch) : m_mod(&mod), m_ch(ch) {}
+    /// Returns the Module this Handle views.
+    inline AOModule& module() const { return *m_mod; }
+    /// Returns the channel number this Handle views.
+    inline ChanNum channel() const { return m_ch; }
     /// Physically writes the voltage currently in the software buffer
-    inline bool write() { return m_mod->write(m_ch, m_mod->get(m_ch)); }
+    inline bool write() { return m_mod->write(m_ch, get_volts()); }
     /// Physically writes the passed value
     inline bool write_volts(Volts v) { return m_mod->write(m_ch, v); }
     /// Sets the current software buffer value
-    inline bool set_volts(Volts v) { return m_mod->set(m_ch, v); }
+    inline bool set_volts(Volts v) {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        if (i == ChanMap::npos)
+            return m_mod->set(m_ch, v);
+        m_mod->at_index(i) = v;
+        return true;
+    }
     /// Returns the current value in the software buffer.
-    inline Volts get_volts() { return m_mod->get(m_ch); }
+    inline Volts get_volts() {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->get()[i] : m_mod->get(m_ch);
+    }
     /// Sets the enable value
     inline bool set_enable(Volts v) { return m_mod->enable_values.set(m_ch, v); }
     /// Sets the disable value
     inline bool set_disable(Volts v) { return m_mod->disable_values.set(m_ch, v); }
 
 protected:
-    AOModule* m_mod;
-    ChanNum   m_ch;
+    AOModule*    m_mod;
+    ChanNum      m_ch;
+    ChannelCache m_cache;
 };
 
 /// A single-channel view into a DOModule
@@ -116,8 +172,12 @@ public:
     DOHandle() {}
     /// Constructor
     DOHandle(DOModule& mod, ChanNum ch) : m_mod(&mod), m_ch(ch) {}
+    /// Returns the Module this Handle views.
+    inline DOModule& module() const { return *m_mod; }
+    /// Returns the channel number this Handle views.
+    inline ChanNum channel() const { return m_ch; }
     /// Physically writes the level currently in the software buffer
-    inline bool write() { return m_mod->write(m_ch, m_mod->get(m_ch)); }
+    inline bool write() { return m_mod->write(m_ch, get_level()); }
     /// Physically writes the passed value
     inline bool write_level(TTL l) { return m_mod->write(m_ch, l); }
     /// Physically writes the output to TTL_HIGH
@@ -125,23 +185,35 @@ public:
     /// Physically writes the output to TTL_LOW
     inline bool write_low() { return m_mod->write(m_ch, TTL_LOW); }
     /// Sets the current software buffer value
-    inline bool set_level(TTL l) { return m_mod->set(m_ch, l); }
+    inline bool set_level(TTL l) {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        if (i == ChanMap::npos)
+            return m_mod->set(m_ch, l);
+        m_mod->at_index(i) = l;
+        return true;
+    }
     /// Sets the current software buffer value to TTL_HIGH
-    inline bool set_high() { return m_mod->set(m_ch, TTL_HIGH); };
+    inline bool set_high() { return set_level(TTL_HIGH); };
     /// Sets the current software buffer value to TTL_LOW
-    inline bool set_low() { return m_mod->set(m_ch, TTL_LOW); }
+    inline bool set_low() { return set_level(TTL_LOW); }
+    /// Returns the current value in the software buffer.
+    inline TTL get_level() {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->get()[i] : m_mod->get(m_ch);
+    }
     /// Flips the current software value (i.e. TTL_LOW becomes TTL_HIGH, vice versa)
-    inline bool flip() { return m_mod->set(m_ch, TTL_HIGH - m_mod->get(m_ch)); }
+    inline bool flip() { return set_level(TTL_HIGH - get_level()); }
     /// Flips the current software value (i.e. TTL_LOW becomes TTL_HIGH, vice versa)
-    inline bool flip_write() { return m_mod->write(m_ch, TTL_HIGH - m_mod->get(m_ch)); }
+    inline bool flip_write() { return m_mod->write(m_ch, TTL_HIGH - get_level()); }
     /// Sets the enable value
     inline bool set_enable(TTL l) { return m_mod->enable_values.set(m_ch, l); }
     /// Sets the disable value
     inline bool set_disable(TTL l) { return m_mod->disable_values.set(m_ch, l); }
 
 protected:
-    DOModule* m_mod;
-    ChanNum   m_ch;
+    DOModule*    m_mod;
+    ChanNum      m_ch;
+    ChannelCache m_cache;
 };
 
 /// A single-channel view into an EncoderModule
@@ -151,16 +223,26 @@ public:
     EncoderHandle() {}
     /// Constructor
     EncoderHandle(EncoderModule& mod, ChanNum ch) : m_mod(&mod), m_ch(ch) {}
+    /// Returns the Module this Handle views.
+    inline EncoderModule& module() const { return *m_mod; }
+    /// Returns the channel number this Handle views.
+    inline ChanNum channel() const { return m_ch; }
     /// Physically reads the counts into the software buffer.
     inline bool read() { return m_mod->read(m_ch); }
     /// Physically reads the counts into the software buffer and returns the value.
     inline Counts read_counts() { return read() ? get_counts() : 0; }
     /// Returns the current counts in the software buffer.
-    inline Counts get_counts() const { return m_mod->get(m_ch); }
+    inline Counts get_counts() const {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->get()[i] : m_mod->get(m_ch);
+    }
     /// Physically reads the counts and returns the converted position.
     inline double read_pos() { return read() ? get_pos() : 0; }
     /// Returns the converted position based on the current counts, quad mode, and units.
-    inline double get_pos() const { return m_mod->positions.get(m_ch); }
+    inline double get_pos() const {
+        std::size_t i = m_cache.index(*m_mod, m_ch);
+        return i != ChanMap::npos ? m_mod->positions.get()[i] : m_mod->positions.get(m_ch);
+    }
     /// Sets the units to be used in position conversions.
     inline bool set_units(double u) { return m_mod->units.set(m_ch, u); }
     /// Writes the quadrature mode that the DAQ will use.
@@ -173,6 +255,105 @@ public:
 protected:
     EncoderModule* m_mod;
     ChanNum        m_ch;
+    ChannelCache   m_cache;
+};
+
+/// A collection of Handles, possibly spanning several Modules of one Daq, that can be
+/// physically read or written together. Rather than one call per Handle, read and write
+/// issue a single batched call per Module with exactly the subset of channels held, e.g.
+/// a robot joint can read its 3 channels in one transaction instead of 3:
+///
+/// HandleGroup joint;
+/// joint.add(AIHandle(q8.AI, 0));
+/// joint.add(EncoderHandle(q8.encoder, 0));
+/// joint.add(AOHandle(q8.AO, 0));
+/// ...
+/// joint.read();  // one AI read for ch 0, one encoder read for ch 0
+/// joint.write(); // one AO write for ch 0
+///
+/// Add Handles on startup; read and write do not allocate.
+class HandleGroup {
+public:
+    /// Adds an AIHandle to be read
+    inline void add(const AIHandle& h) { add_read(h.module(), h.channel()); }
+    /// Adds a DIHandle to be read
+    inline void add(const DIHandle& h) { add_read(h.module(), h.channel()); }
+    /// Adds an EncoderHandle to be read
+    inline void add(const EncoderHandle& h) { add_read(h.module(), h.channel()); }
+    /// Adds an AOHandle to be written
+    inline void add(const AOHandle& h) { add_write(h.module(), h.channel()); }
+    /// Adds a DOHandle to be written
+    inline void add(const DOHandle& h) { add_write(h.module(), h.channel()); }
+    /// Adds a channel of any IRead Buffer to be read
+    template <typename B>
+    void add_read(B& buffer, ChanNum ch) {
+        add(m_reads, &buffer, &HandleGroup::read_batch<B>, ch);
+    }
+    /// Adds a channel of any IWrite Buffer to be written from its software buffer
+    template <typename B>
+    void add_write(B& buffer, ChanNum ch) {
+        add(m_writes, &buffer, &HandleGroup::write_batch<B>, ch);
+    }
+    /// Physically reads every added input channel, one read per Module (and per 64 channels).
+    /// Returns true if all reads succeeded.
+    bool read() {
+        bool success = true;
+        for (auto& b : m_reads)
+            success = b.invoke(b.buffer, b.chs) ? success : false;
+        return success;
+    }
+    /// Physically writes the current software buffer value of every added output channel,
+    /// one write per Module (and per 64 channels). Returns true if all writes succeeded.
+    bool write() {
+        bool success = true;
+        for (auto& b : m_writes)
+            success = b.invoke(b.buffer, b.chs) ? success : false;
+        return success;
+    }
+
+private:
+    /// The channels of one Buffer and the type restoring function that reads/writes them
+    struct Batch {
+        void*    buffer;
+        bool     (*invoke)(void* buffer, const ChanNums& chs);
+        ChanNums chs;
+    };
+    /// Adds ch to the Batch for buffer, creating it if needed
+    static void add(std::vector<Batch>& batches, void* buffer,
+                    bool (*invoke)(void*, const ChanNums&), ChanNum ch) {
+        for (auto& b : batches) {
+            if (b.buffer == buffer) {
+                auto it = std::lower_bound(b.chs.begin(), b.chs.end(), ch);
+                if (it == b.chs.end() || *it != ch)
+                    b.chs.insert(it, ch);
+                return;
+            }
+        }
+        batches.push_back({buffer, invoke, {ch}});
+    }
+    /// Reads a Batch of B
+    template <typename B>
+    static bool read_batch(void* buffer, const ChanNums& chs) {
+        return static_cast<B*>(buffer)->read(Span<ChanNum>(chs));
+    }
+    /// Writes a Batch of B from its software buffer
+    template <typename B>
+    static bool write_batch(void* buffer, const ChanNums& chs) {
+        B* b = static_cast<B*>(buffer);
+        for (std::size_t first = 0; first < chs.size(); first += 64) {
+            std::size_t      n = chs.size() - first > 64 ? 64 : chs.size() - first;
+            typename B::Type values[64];
+            for (std::size_t i = 0; i < n; ++i)
+                values[i] = b->get(chs[first + i]);
+            if (!b->write(Span<ChanNum>(chs.data() + first, n), Span<typename B::Type>(values, n)))
+                return false;
+        }
+        return true;
+    }
+
+private:
+    std::vector<Batch> m_reads;   ///< input Buffers and their channels
+    std::vector<Batch> m_writes;  ///< output Buffers and their channels
 };
 
 }  // namespace daq
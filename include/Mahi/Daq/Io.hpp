@@ -17,6 +17,8 @@
 #pragma once
 #include <Mahi/Daq/Module.hpp>
 #include <Mahi/Daq/Buffer.hpp>
+#include <Mahi/Util/Event.hpp>
+#include <cstdint>
 
 namespace mahi {
 namespace daq {
@@ -78,8 +80,64 @@ public:
 /// Convenience type for analog input DAQ Module interfaces
 typedef InputModule<Volts> AIModule;
 
-/// Convenience type for digital input DAQ Module interfaces
-typedef InputModule<TTL> DIModule;
+/// Digital input DAQ Module interface. Optionally detects edges after every read (see
+/// enable_edges): the channels are packed into 64-bit words, so finding which of them rose
+/// or fell is a couple of word-wide operations per 64 channels, and on_edge is only called
+/// for the channels that changed.
+///
+/// di.enable_edges(true, 3);  // accept changes that persist for 3 reads
+/// di.on_edge.connect([](ChanNum ch, bool rising) { ... });
+/// ...
+/// daq.read_all();
+/// if (di.rose(2)) { ... }
+class DIModule : public InputModule<TTL> {
+public:
+    /// Constructor
+    DIModule(Daq& daq, const ChanNums& allowed);
+    /// Enables or disables edge detection. A channel's state only changes once its input has
+    /// read the new level debounce consecutive times (0 or 1 accepts changes immediately).
+    /// The first read after enabling or set_channels captures the initial state without
+    /// reporting edges. TTL_ERROR is treated as high.
+    void enable_edges(bool enable = true, unsigned int debounce = 0);
+    /// Returns true if channel ch rose in the last read (channel must be valid)
+    bool rose(ChanNum ch) const { return bit(m_rising, ch); }
+    /// Returns true if channel ch fell in the last read (channel must be valid)
+    bool fell(ChanNum ch) const { return bit(m_falling, ch); }
+    /// Returns the debounced state of channel ch (channel must be valid)
+    bool state(ChanNum ch) const { return bit(m_state, ch); }
+    /// Rising edges of the last read, bit i of word i / 64 for the channel at index i of channels()
+    const std::vector<std::uint64_t>& rising() const { return m_rising; }
+    /// Falling edges of the last read, laid out like rising
+    const std::vector<std::uint64_t>& falling() const { return m_falling; }
+    /// Called after a read for every channel whose debounced state changed, with the public
+    /// channel number and true for a rising edge, false for a falling edge
+    util::Event<void(ChanNum, bool)> on_edge;
+
+protected:
+    /// Resets edge detection after channels change. Overrides Buffer::remap.
+    void remap(const ChanMap& old_map, const ChanMap& new_map) override;
+
+private:
+    /// Post-read stage: packs the buffer, debounces it and finds and dispatches edges
+    void detect_edges();
+    /// Returns bit ch of words
+    bool bit(const std::vector<std::uint64_t>& words, ChanNum ch) const {
+        std::size_t i = index(ch);
+        return i / 64 < words.size() && ((words[i / 64] >> (i % 64)) & 1);
+    }
+
+private:
+    bool                       m_edges;      ///< true if edge detection is enabled
+    bool                       m_connected;  ///< true once detect_edges is connected to post_read
+    bool                       m_primed;     ///< true once the initial state has been captured
+    unsigned int               m_debounce;   ///< reads a change must persist for
+    std::vector<std::uint64_t> m_raw;        ///< packed input levels of the last read
+    std::vector<std::uint64_t> m_state;      ///< packed debounced state
+    std::vector<std::uint64_t> m_rising;     ///< packed rising edges of the last read
+    std::vector<std::uint64_t> m_falling;    ///< packed falling edges of the last read
+    std::vector<std::uint64_t> m_pending;    ///< packed channels whose level differs from their state
+    std::vector<unsigned int>  m_counts;     ///< debounce counters by buffer index
+};
 
 //==============================================================================
 // OUTPUT MODULES
@@ -145,13 +203,21 @@ public:
 class EncoderModuleBasic : public ChanneledModule, public ReadWriteBuffer<Counts> {
 public:
     EncoderModuleBasic(Daq& daq, const ChanNums& allowed) :
-        ChanneledModule(daq, allowed), ReadWriteBuffer<Counts>(*this, 0) {
+        ChanneledModule(daq, allowed), ReadWriteBuffer<Counts>(*this, 0), m_zeros(allowed.size()) {
         read_with_all = true;
     }
     /// Zeros all encoder channels.
-    bool zero() { return write(std::vector<Counts>(channels_internal().size())); }
+    bool zero() {
+        std::size_t n = channels_internal().size();
+        Counts* zeros = m_zeros.get(n);
+        std::fill(zeros, zeros + n, 0);
+        return write(Span<Counts>(zeros, n));
+    }
     /// Zeros a single encoder channel.
     bool zero(ChanNum channel) { return write(channel, 0); }
+
+private:
+    Scratch<Counts> m_zeros;  ///< zeros written by zero()
 };
 
 /// A incremental Encoder DAQ Module interface. It itself is a ReadWriteBuffer<Count>,
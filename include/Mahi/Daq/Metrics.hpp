@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace mahi {
+namespace daq {
+
+/// Summary of a LatencyHistogram. Percentiles are the upper edge of the bucket they
+/// fall in, so they overestimate by at most 12.5%.
+struct LatencyStats {
+    std::uint64_t count;    ///< number of recorded samples
+    std::uint64_t p50_ns;   ///< median latency in [ns]
+    std::uint64_t p99_ns;   ///< 99th percentile latency in [ns]
+    std::uint64_t p999_ns;  ///< 99.9th percentile latency in [ns]
+    std::uint64_t max_ns;   ///< largest recorded latency in [ns]
+};
+
+#ifdef MAHI_DAQ_METRICS
+
+/// A fixed-bucket latency histogram. Recording is lock-free and never allocates, so it can
+/// be done from a real-time thread while other threads query or reset it. Buckets are
+/// logarithmic with 8 linear sub-buckets per power of two, covering 0 ns to about an hour.
+class LatencyHistogram {
+public:
+    /// Number of buckets
+    static constexpr std::size_t NumBuckets = 320;
+    /// Constructor
+    LatencyHistogram() { reset(); }
+    /// Records a latency in [ns]
+    inline void record(std::uint64_t ns) {
+        m_buckets[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        std::uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {}
+    }
+    /// Returns the number of recorded samples
+    std::uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    /// Returns the latency in [ns] below which fraction p (e.g. 0.99) of samples fall
+    std::uint64_t percentile(double p) const;
+    /// Returns count, p50, p99, p99.9 and max
+    LatencyStats stats() const;
+    /// Zeros all counters
+    void reset();
+
+private:
+    /// Returns the bucket index for a latency in [ns]
+    static std::size_t bucket(std::uint64_t ns);
+    /// Returns the largest latency in [ns] that falls in bucket i
+    static std::uint64_t bucket_max(std::size_t i);
+
+private:
+    std::atomic<std::uint64_t> m_buckets[NumBuckets];  ///< sample counts per bucket
+    std::atomic<std::uint64_t> m_count;                ///< total sample count
+    std::atomic<std::uint64_t> m_max;                  ///< largest sample
+};
+
+inline std::size_t LatencyHistogram::bucket(std::uint64_t ns) {
+    if (ns < 8)
+        return static_cast<std::size_t>(ns);
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned e = 63 - static_cast<unsigned>(__builtin_clzll(ns));
+#else
+    unsigned e = 3;
+    while (e < 63 && (ns >> (e + 1)))
+        ++e;
+#endif
+    std::size_t i = (e - 2) * 8 + static_cast<std::size_t>((ns >> (e - 3)) & 7);
+    return i < NumBuckets ? i : NumBuckets - 1;
+}
+
+/// Measures the lifetime of a scope into a LatencyHistogram
+class LatencyTimer {
+public:
+    /// Starts timing
+    LatencyTimer(LatencyHistogram& histogram) :
+        m_histogram(histogram), m_start(std::chrono::steady_clock::now()) {}
+    /// Records the elapsed time
+    ~LatencyTimer() { m_histogram.record(elapsed_ns()); }
+    /// Returns the time elapsed since construction in [ns]
+    inline std::uint64_t elapsed_ns() const {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+private:
+    LatencyHistogram&                     m_histogram;  ///< the histogram to record into
+    std::chrono::steady_clock::time_point m_start;      ///< when timing started
+};
+
+#else
+
+/// Empty stand-in used when MAHI_DAQ_METRICS is not defined. Nothing is recorded and
+/// all queries return zero, so instrumentation compiles away.
+class LatencyHistogram {
+public:
+    inline void          record(std::uint64_t) {}
+    inline std::uint64_t count() const { return 0; }
+    inline std::uint64_t percentile(double) const { return 0; }
+    inline LatencyStats  stats() const { return LatencyStats{0, 0, 0, 0, 0}; }
+    inline void          reset() {}
+};
+
+/// Empty stand-in used when MAHI_DAQ_METRICS is not defined
+class LatencyTimer {
+public:
+    LatencyTimer(LatencyHistogram&) {}
+    inline std::uint64_t elapsed_ns() const { return 0; }
+};
+
+#endif
+
+}  // namespace daq
+}  // namespace mahi
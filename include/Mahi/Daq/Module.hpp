@@ -16,8 +16,10 @@
 
 #pragma once
 #include <Mahi/Daq/Types.hpp>
+#include <Mahi/Daq/Metrics.hpp>
 #include <Mahi/Util/Device.hpp>
 #include <Mahi/Util/Event.hpp>
+#include <cstdint>
 #include <map>
 
 namespace mahi {
@@ -81,12 +83,42 @@ public:
     const ChanNums& channels_internal() const;
     //// Returns true if this Module shares pins with another.
     bool shares_pins() const;
+    /// Returns a counter that changes whenever set_channels changes the channels. Buffer
+    /// indices and value addresses stay valid until it changes, so Handles cache them
+    /// against it (see ChannelCache).
+    inline std::uint64_t generation() const { return m_generation; }
+    /// Returns the buffer index of public channel ch, or ChanMap::npos if it is not maintained
+    inline std::size_t channel_index(ChanNum ch) const { return m_ch_map.find(ch); }
+    /// Enables or disables lock-free snapshots of all of this Module's Buffers. When enabled,
+    /// every successful read publishes a copy of each Buffer that other threads can safely
+    /// retrieve with Buffer::snapshot. Like set_channels, call this on startup before other
+    /// threads start fetching snapshots.
+    void enable_snapshots(bool enable = true);
+    /// Publishes snapshots of this Module's Buffers if snapshots are enabled. This is called
+    /// automatically after successful reads, but custom Daqs that emit post_read themselves
+    /// (e.g. QuanserDaq) should call it afterwards.
+    inline void publish_snapshots() {
+        if (!m_snapshots.empty())
+            publish_snapshots_impl();
+    }
+    /// Returns the histogram of this Module's read durations, including those done by read_all.
+    /// Empty unless mahi::daq was built with MAHI_DAQ_METRICS (see Metrics.hpp).
+    LatencyHistogram& read_latency() { return m_read_latency; }
+    /// Returns the histogram of this Module's read durations
+    const LatencyHistogram& read_latency() const { return m_read_latency; }
+    /// Returns the histogram of this Module's write durations, including those done by write_all.
+    /// Empty unless mahi::daq was built with MAHI_DAQ_METRICS (see Metrics.hpp).
+    LatencyHistogram& write_latency() { return m_write_latency; }
+    /// Returns the histogram of this Module's write durations
+    const LatencyHistogram& write_latency() const { return m_write_latency; }
     /// Shared pins data structure
 protected:
     /// Converts a public facing channel number to the internal representation.
     /// Passes through by default. Override if your DAQ API channel indexing is
     /// different from the interface indexing you you want clients to use.
     virtual ChanNum convert_channel(ChanNum public_facing) const;   
+    /// Called before set_channels changes the channels. Return false to refuse the change.
+    virtual bool on_set_channels(const ChanNums& chs) { return true; }
     /// Called when new channels have been gained
     virtual bool on_gain_channels(const ChanNums& chs) { return true; }
     /// Called when old channels have been freed
@@ -113,6 +145,20 @@ protected:
     inline void connect_post_write(B& buffer, F func) {
         buffer.post_write.connect(func);
     }
+    /// Bind member function F of this Module M as the Buffer's read implementation at
+    /// compile time, e.g. bind_read<MyAI, Volts, &MyAI::read_impl>(*this). Unlike
+    /// connect_read, the call is static and can be inlined. Replaces any on_read(s).
+    template <typename M, typename T, bool (M::*F)(const ChanNum*, T*, std::size_t), typename B>
+    inline void bind_read(B& buffer) {
+        buffer.template set_read_impl<M, F>();
+    }
+    /// Bind member function F of this Module M as the Buffer's write implementation at
+    /// compile time, e.g. bind_write<MyAO, Volts, &MyAO::write_impl>(*this). Unlike
+    /// connect_write, the call is static and can be inlined. Replaces any on_write(s).
+    template <typename M, typename T, bool (M::*F)(const ChanNum*, const T*, std::size_t), typename B>
+    inline void bind_write(B& buffer) {
+        buffer.template set_write_impl<M, F>();
+    }
 
 private:
     friend Daq;
@@ -125,6 +171,13 @@ private:
     ChanNums m_chs_internal;  ///< The current internal facing channel numbers
     ChanMap  m_ch_map;        ///< Maps a public facing channel number to a buffer index position
     std::vector<BufferBase*> m_buffs;  ///< Buffers maintained  by this Module
+    std::vector<BufferBase*> m_snapshots;  ///< Buffers publishing snapshots (empty if disabled)
+    std::uint64_t m_snapshot_cycle;        ///< Number of times snapshots have been published
+    std::uint64_t m_generation;            ///< Incremented when the channels change
+    LatencyHistogram m_read_latency;       ///< Durations of this Module's reads
+    LatencyHistogram m_write_latency;      ///< Durations of this Module's writes
+    /// Publishes all Buffers in m_snapshots
+    void publish_snapshots_impl();
 };
 
 }  // namespace daq
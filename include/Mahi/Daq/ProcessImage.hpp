@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Util/NonCopyable.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+class BufferBase;
+
+/// A PLC-style process image: the values of every Buffer on a Daq packed into one
+/// contiguous block, with the inputs (Readables and Buffers computed from them, e.g.
+/// positions) and the outputs (Writeables that are not also Readable, e.g. AO and
+/// registers) in separate cache-line-aligned sections. The Daq refreshes the input section
+/// after each successful read_all and the output section after each successful write_all,
+/// so a whole cycle can be snapshotted, logged or transmitted with a single memcpy of
+/// data(). Enable it with Daq::enable_process_image. The Buffers themselves are unchanged.
+class ProcessImage : util::NonCopyable {
+public:
+    /// Alignment of the image and of its input and output sections
+    static constexpr std::size_t Alignment = 64;
+    /// Returned by offset for Buffers that are not in the image
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /// Where one Buffer's values live in the image
+    struct Section {
+        const BufferBase* buffer;  ///< the Buffer
+        const void*       source;  ///< the Buffer's values at layout time
+        std::size_t       offset;  ///< byte offset of the values from data()
+        std::size_t       bytes;   ///< byte size of the values
+    };
+
+    /// Constructor, creates an empty image
+    ProcessImage();
+    /// Returns the start of the image
+    const unsigned char* data() const { return m_data; }
+    /// Returns the size of the image in bytes
+    std::size_t size() const { return m_size; }
+    /// Returns the start of the input section
+    const unsigned char* inputs() const { return m_data; }
+    /// Returns the size of the input section in bytes
+    std::size_t inputs_size() const { return m_outputs_offset; }
+    /// Returns the start of the output section
+    const unsigned char* outputs() const { return m_data + m_outputs_offset; }
+    /// Returns the size of the output section in bytes
+    std::size_t outputs_size() const { return m_size - m_outputs_offset; }
+    /// Returns the Sections of the input Buffers
+    const std::vector<Section>& input_sections() const { return m_inputs; }
+    /// Returns the Sections of the output Buffers
+    const std::vector<Section>& output_sections() const { return m_outputs; }
+    /// Returns the byte offset of a Buffer's values from data(), or npos if it is not in the image
+    std::size_t offset(const BufferBase& buffer) const;
+    /// Returns the number of times the image has been laid out. Offsets and sizes are only
+    /// valid for the layout they were queried from (set_channels causes a new layout).
+    std::uint64_t layout_count() const { return m_layouts; }
+    /// Copies the entire image into dst, which must hold size() bytes
+    void copy(void* dst) const;
+
+    /// Lays out the image for the given Buffers. Called by Daq when its plan is recompiled.
+    void layout(const std::vector<BufferBase*>& buffers);
+    /// Copies the input Buffers into the image
+    void capture_inputs();
+    /// Copies the output Buffers into the image
+    void capture_outputs();
+
+private:
+    /// Appends Sections for buffers to sections starting at cursor, returning the new cursor
+    static std::size_t place(const std::vector<BufferBase*>& buffers, std::vector<Section>& sections, std::size_t cursor);
+    /// Copies each Section's source into the image
+    void capture(const std::vector<Section>& sections);
+
+private:
+    std::vector<unsigned char> m_storage;         ///< backing memory, over-allocated for alignment
+    unsigned char*             m_data;            ///< aligned start of the image within m_storage
+    std::size_t                m_size;            ///< image size in bytes
+    std::size_t                m_outputs_offset;  ///< offset of the output section
+    std::vector<Section>       m_inputs;          ///< input Buffer Sections
+    std::vector<Section>       m_outputs;         ///< output Buffer Sections
+    std::uint64_t              m_layouts;         ///< see layout_count
+};
+
+}  // namespace daq
+}  // namespace mahi
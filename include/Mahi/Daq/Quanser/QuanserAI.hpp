@@ -29,6 +29,7 @@ public:
     Register<Range<Volts>> ranges;
 private:
     friend QuanserDaq;
+    bool read_impl(const ChanNum* chs, Volts* vals, std::size_t n);
     QuanserHandle& m_h;
 };
 
@@ -31,6 +31,7 @@ private:
     bool init_channels(const ChanNums& chs);
     bool on_daq_open() override;
     bool on_gain_channels(const ChanNums& chs) override;
+    bool read_impl(const ChanNum* chs, TTL* vals, std::size_t n);
     QuanserHandle& m_h;
     bool m_bidirectional;    
 };
@@ -44,6 +44,8 @@ public:
     virtual bool read_all() override;
     /// Override write_all to use a more efficient Quanser API call
     virtual bool write_all() override;
+    /// Overrides write_read_all to write and read in a single hil_write_read transaction
+    virtual bool write_read_all() override;
     /// Set Quanser DAQ specific options
     bool set_options(const QuanserOptions& options);
     /// Set Quanser DAQ specific options
@@ -34,6 +34,7 @@ private:
     bool init_channels(const ChanNums& chs);
     bool on_daq_open() override;
     bool on_gain_channels(const ChanNums& chs) override;
+    bool read_impl(const ChanNum* chs, Counts* counts, std::size_t n);
     QuanserHandle& m_h;
 };
 
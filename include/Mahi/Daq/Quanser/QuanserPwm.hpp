@@ -52,6 +52,7 @@ private:
     bool on_daq_open() override;
     bool on_gain_channels(const ChanNums& chs) override;
     bool on_free_channels(const ChanNums& chs) override;
+    bool write_impl(const ChanNum* chs, const double* vals, std::size_t n);
     std::function<bool(const ChanNums&)> m_on_gain_custom;
     std::function<bool(const ChanNums&)> m_on_free_custom;
     QuanserHandle& m_h;
@@ -0,0 +1,62 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+#include <Mahi/Util/NonCopyable.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace mahi {
+namespace daq {
+
+/// Real-time settings that can be applied to a thread (see configure_realtime)
+struct RealtimeOptions {
+    /// Constructor
+    RealtimeOptions(int cpu = -1, int priority = 0, bool lock_memory = false, std::size_t prefault_stack = 0) :
+        cpu(cpu), priority(priority), lock_memory(lock_memory), prefault_stack(prefault_stack) {}
+    int         cpu;             ///< the CPU core to pin the thread to, or -1 to leave affinity unchanged
+    int         priority;        ///< SCHED_FIFO priority (1-99), or 0 to leave the scheduler unchanged
+    bool        lock_memory;     ///< if true, lock all current and future pages in RAM (mlockall)
+    std::size_t prefault_stack;  ///< bytes of stack to touch up front so the loop never page faults on it
+};
+
+/// Applies the requested real-time settings to the calling thread. Only Linux
+/// (including NI Linux RT) is supported; on other platforms any requested
+/// setting fails. Returns true if every requested setting took effect.
+bool configure_realtime(const RealtimeOptions& options);
+
+/// Saves the calling thread's CPU affinity and scheduler on construction and restores them
+/// on destruction, so that a loop which applies configure_realtime to its caller's thread can
+/// undo it when it returns. Locked memory (mlockall) is process-wide and stays locked.
+class RealtimeGuard : util::NonCopyable {
+public:
+    /// Constructor. Saves the calling thread's settings.
+    RealtimeGuard();
+    /// Destructor. Restores the saved settings on the calling thread.
+    ~RealtimeGuard();
+
+private:
+    struct State;
+    std::unique_ptr<State> m_state;  ///< the saved settings (platform specific)
+};
+
+/// Touches the next bytes of the calling thread's stack so that its pages are mapped (and,
+/// after mlockall, locked) before a real-time loop needs them. Works on all platforms.
+void prefault_stack(std::size_t bytes);
+
+}  // namespace daq
+}  // namespace mahi
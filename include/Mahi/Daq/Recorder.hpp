@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Handle.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// Records selected Buffer channels to a compact binary file at high rates. Each cycle the
+/// real-time thread calls #record, which copies the values into a preallocated wait-free
+/// ring; a background thread drains the ring to disk. If the writer falls behind, rows are
+/// dropped and counted rather than blocking the real-time thread. Convert recordings to CSV
+/// with Recorder::to_csv.
+///
+/// Recorder rec;
+/// rec.add(q8.AI, 0);
+/// rec.add(EncoderHandle(q8.encoder, 1), "joint1");
+/// rec.open("run.mrec");
+/// thread.update = [&](Time t) { ...; rec.record(t); };
+///
+/// File layout (native byte order): the 8 byte magic "MAHIREC1", uint32 column count, then
+/// per column a uint32 name length and the name; then rows of float64 time in [s] followed
+/// by one float64 per column.
+class Recorder : util::NonCopyable {
+public:
+    /// Constructor. The ring holds up to capacity rows awaiting disk.
+    Recorder(std::size_t capacity = 8192);
+    /// Destructor. Closes the recording if open.
+    ~Recorder();
+    /// Adds a channel of any IGet Buffer as a column. Columns must be added before open.
+    /// If name is empty, the column is named after the Module and channel, e.g. "q8.AI[0]".
+    template <typename B>
+    bool add(const B& buffer, ChanNum ch, const std::string& name = "") {
+        return add_column(&buffer, &Recorder::get_value<B>, buffer.module(), ch, name);
+    }
+    /// Adds an AIHandle as a column
+    inline bool add(const AIHandle& h, const std::string& name = "") { return add(h.module(), h.channel(), name); }
+    /// Adds a DIHandle as a column
+    inline bool add(const DIHandle& h, const std::string& name = "") { return add(h.module(), h.channel(), name); }
+    /// Adds an AOHandle as a column
+    inline bool add(const AOHandle& h, const std::string& name = "") { return add(h.module(), h.channel(), name); }
+    /// Adds a DOHandle as a column
+    inline bool add(const DOHandle& h, const std::string& name = "") { return add(h.module(), h.channel(), name); }
+    /// Adds an EncoderHandle as a column (in counts)
+    inline bool add(const EncoderHandle& h, const std::string& name = "") { return add(h.module(), h.channel(), name); }
+    /// Opens filename, writes the header and starts the writer thread
+    bool open(const std::string& filename);
+    /// Drains all remaining rows to disk, stops the writer thread and closes the file. Stop
+    /// calling record (e.g. stop the DaqThread) first.
+    void close();
+    /// Returns true if a recording is open
+    bool is_open() const;
+    /// Copies the current value of every column into the ring, stamped with time t. Wait-free
+    /// and allocation-free; call from the real-time thread once per cycle. Returns false (and
+    /// counts a drop) if the ring is full or no recording is open.
+    bool record(util::Time t);
+    /// Returns the number of rows accepted by record
+    std::uint64_t recorded() const;
+    /// Returns the number of rows dropped because the ring was full
+    std::uint64_t dropped() const;
+    /// Returns the number of rows written to disk
+    std::uint64_t written() const;
+    /// Returns the column names
+    const std::vector<std::string>& columns() const;
+    /// Converts a recording to a CSV file with a header row. Returns true on success.
+    static bool to_csv(const std::string& recording, const std::string& csv);
+
+private:
+    /// Reads a channel of Buffer B as a double
+    template <typename B>
+    static double get_value(const void* buffer, ChanNum ch) {
+        return static_cast<double>(static_cast<const B*>(buffer)->get(ch));
+    }
+    /// Type erased implementation of add
+    bool add_column(const void* buffer, double (*get)(const void*, ChanNum),
+                    const ChanneledModule& module, ChanNum ch, const std::string& name);
+    /// Writer thread entry point
+    void run();
+    /// Writes all rows currently in the ring. Returns false on an I/O error.
+    bool drain();
+
+private:
+    /// A recorded channel
+    struct Column {
+        const void* buffer;                      ///< the Buffer
+        double      (*get)(const void*, ChanNum); ///< type restoring value getter
+        ChanNum     ch;                          ///< the channel
+    };
+    std::vector<Column>        m_columns;   ///< recorded channels
+    std::vector<std::string>   m_names;     ///< column names
+    std::size_t                m_capacity;  ///< ring capacity in rows
+    std::size_t                m_stride;    ///< doubles per row (time + columns)
+    std::vector<double>        m_ring;      ///< ring storage, (capacity + 1) * stride
+    std::FILE*                 m_file;      ///< the open recording
+    std::thread                m_thread;    ///< the writer thread
+    std::atomic<bool>          m_running;   ///< true while the writer should keep draining
+    std::atomic<std::uint64_t> m_recorded;  ///< see recorded
+    std::atomic<std::uint64_t> m_dropped;   ///< see dropped
+    std::atomic<std::uint64_t> m_written;   ///< see written
+    alignas(64) std::atomic<std::size_t> m_head;  ///< next row to write (owned by writer)
+    alignas(64) std::atomic<std::size_t> m_tail;  ///< next row to record (owned by record)
+};
+
+}  // namespace daq
+}  // namespace mahi
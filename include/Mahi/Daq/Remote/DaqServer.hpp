@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Daq/Remote/Protocol.hpp>
+#include <atomic>
+#include <thread>
+
+namespace mahi {
+namespace daq {
+
+class BufferBase;
+
+/// Serves a local Daq to RemoteDaq clients over UDP, e.g. a myRIO running NI Linux RT
+/// serving a controller on a workstation. Every Readable read by read_all and every
+/// Writeable of type double, Counts or TTL is served. A client cycle is a single
+/// request/reply exchange: the request carries all outputs, the server writes and reads
+/// its Daq (with write_read_all when both are requested, so synced DAQs do one transaction)
+/// and the reply carries all inputs. Requests are answered in order by sequence number;
+/// a retransmitted request is answered from the last reply without touching the Daq again.
+/// The server drives actuators, so it listens on loopback unless told otherwise, and serves
+/// one client at a time: Cycle requests are only accepted from the sender of the last
+/// accepted Describe. Another client's Describe is refused until the current client has
+/// been silent for a second (e.g. because it was restarted).
+///
+/// Q8Usb q8;
+/// q8.AI.set_channels({0, 1});
+/// DaqServer server(q8);
+/// server.open(RemotePort, "0.0.0.0");  // serve every interface, not just loopback
+/// server.start();         // or call poll in your own loop
+///
+/// Set channels before open and do not change them while serving. While running, only the
+/// server thread may touch the Daq.
+class DaqServer : util::NonCopyable {
+public:
+    /// Constructor
+    DaqServer(Daq& daq);
+    /// Destructor. Stops and closes the server.
+    ~DaqServer();
+    /// Describes the Daq's streams and binds port (0 picks a free port, see port) on the
+    /// interface with IPv4 address. The default serves this machine only; pass "0.0.0.0"
+    /// for all interfaces, or the address of the one facing the client.
+    bool open(unsigned short port = RemotePort, const std::string& address = "127.0.0.1");
+    /// Stops the server thread if running and closes the socket
+    void close();
+    /// Returns true if the server is open
+    bool is_open() const;
+    /// Returns the bound UDP port
+    unsigned short port() const;
+    /// Waits up to timeout for a request and answers it. Returns true if a request was handled.
+    bool poll(util::Time timeout);
+    /// Starts a thread that answers requests until stop is called
+    bool start(const RealtimeOptions& options = RealtimeOptions());
+    /// Stops the server thread
+    void stop();
+    /// Returns true if the server thread is running
+    bool is_running() const;
+    /// Returns the number of Cycle requests answered
+    std::uint64_t cycles() const;
+    /// Returns the served streams
+    const std::vector<TraceStream>& streams() const;
+
+private:
+    /// A served Buffer
+    struct Stream {
+        BufferBase* buffer;    ///< the Buffer
+        Readable*   readable;  ///< the Buffer as a Readable (inputs)
+        Writeable*  writable;  ///< the Buffer as a Writeable (outputs)
+    };
+    /// Collects the served streams
+    void describe();
+    /// Answers a request of size bytes in m_rx
+    void handle(std::size_t size);
+    /// Executes a Cycle request, returning false if the Daq failed
+    bool cycle(const RemoteHeader& request, const char* payload);
+    /// Sends m_tx with a header of type, flags and payload size
+    void reply(const RemoteHeader& request, RemoteMessage type, std::uint8_t flags, std::size_t size, std::int64_t server_ns);
+
+private:
+    Daq&                       m_daq;        ///< the served Daq
+    UdpSocket                  m_socket;     ///< the server socket
+    std::vector<TraceStream>   m_schema;     ///< served streams, inputs first
+    std::vector<Stream>        m_inputs;     ///< served input Buffers
+    std::vector<Stream>        m_outputs;    ///< served output Buffers
+    std::size_t                m_in_bytes;   ///< size of all input values
+    std::vector<char>          m_rx;         ///< receive buffer
+    std::vector<char>          m_tx;         ///< reply buffer
+    std::size_t                m_tx_size;    ///< size of the last reply
+    std::uint32_t              m_last_seq;   ///< sequence number of the last Cycle answered
+    bool                       m_answered;   ///< true once a Cycle was answered
+    bool                       m_client;     ///< true once a client's Describe was accepted
+    std::int64_t               m_heard_ns;   ///< time the client was last heard from in [ns]
+    std::thread                m_thread;     ///< the server thread
+    std::atomic<bool>          m_running;    ///< true while the server thread should keep serving
+    std::atomic<std::uint64_t> m_cycles;     ///< see cycles
+};
+
+} // namespace daq
+} // namespace mahi
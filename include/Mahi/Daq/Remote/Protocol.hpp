@@ -0,0 +1,113 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Trace.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// Message types of the remote DAQ protocol (see DaqServer and RemoteDaq)
+enum class RemoteMessage : std::uint8_t {
+    Describe = 1,  ///< client -> server: requests the Schema
+    Schema   = 2,  ///< server -> client: the served streams
+    Cycle    = 3,  ///< client -> server: outputs to write and/or a request to read all inputs
+    State    = 4   ///< server -> client: the outcome of a Cycle and the inputs read
+};
+
+/// Flags of Cycle and State messages
+enum RemoteFlag : std::uint8_t {
+    RemoteWrite  = 1,  ///< the Cycle carries outputs to write
+    RemoteRead   = 2,  ///< the Cycle requests all inputs to be read
+    RemoteFailed = 4   ///< the server's Daq reported a failed read or write
+};
+
+/// The header of every remote DAQ datagram. Datagrams are in native byte order (all
+/// supported targets are little-endian).
+///
+/// Schema payload: uint32 stream count, then per stream a uint32 name length and the
+/// Module name, uint8 output flag, uint8 TraceType, uint16 value size, uint32 channel count
+/// and the public channel numbers as uint32. Cycle payload: per output stream a uint8
+/// present flag, followed by its values if present. State payload: the values of every
+/// input stream in schema order.
+struct RemoteHeader {
+    std::uint32_t magic;      ///< RemoteMagic
+    RemoteMessage type;       ///< the message type
+    std::uint8_t  flags;      ///< RemoteFlags
+    std::uint16_t reserved;   ///< zero
+    std::uint32_t seq;        ///< sequence number, echoed in the reply
+    std::uint32_t size;       ///< payload size in bytes
+    std::int64_t  client_ns;  ///< the client's send time in [ns], echoed in the reply
+    std::int64_t  server_ns;  ///< the time the server spent on its Daq in [ns] (replies only)
+};
+
+/// "MDQ1" as a little-endian uint32
+const std::uint32_t RemoteMagic = 0x3151444D;
+/// The default UDP port of DaqServer
+const unsigned short RemotePort = 7400;
+/// The largest UDP payload
+const std::size_t RemoteMaxDatagram = 65507;
+
+/// Appends the Schema payload describing streams to out
+void encode_schema(const std::vector<TraceStream>& streams, std::vector<char>& out);
+/// Parses a Schema payload. Returns false if it is malformed.
+bool decode_schema(const char* data, std::size_t size, std::vector<TraceStream>& streams);
+
+/// A minimal UDP socket with blocking, timed receives. Only implemented on POSIX platforms.
+class UdpSocket : util::NonCopyable {
+public:
+    /// Constructor
+    UdpSocket();
+    /// Destructor. Closes the socket.
+    ~UdpSocket();
+    /// Opens the socket and binds it to port on the interface with IPv4 address (0 picks a
+    /// free port, "0.0.0.0" binds all interfaces)
+    bool bind(const std::string& address, unsigned short port);
+    /// Opens the socket and sets host:port as the destination of send
+    bool connect(const std::string& host, unsigned short port);
+    /// Closes the socket
+    void close();
+    /// Returns true if the socket is open
+    bool is_open() const;
+    /// Returns the local port
+    unsigned short port() const;
+    /// Sends a datagram to the connected host, or to the sender of the last datagram received
+    bool send(const void* data, std::size_t size);
+    /// Waits up to timeout for a datagram. Returns its size, 0 on timeout, or -1 on error.
+    long receive(void* data, std::size_t capacity, util::Time timeout);
+    /// Remembers the sender of the last datagram received as the peer (see from_peer)
+    void set_peer();
+    /// Returns true if the last datagram received came from the peer (false if none is set)
+    bool from_peer() const;
+    /// Returns the address and port of the sender of the last datagram received
+    std::string sender() const;
+
+private:
+    int           m_fd;         ///< socket descriptor (-1 if closed)
+    bool          m_connected;  ///< true if connect was used
+    unsigned char m_peer[128];  ///< sockaddr of the last sender
+    unsigned int  m_peer_size;  ///< size of m_peer in use
+    unsigned char m_kept[128];  ///< sockaddr remembered by set_peer
+    unsigned int  m_kept_size;  ///< size of m_kept in use (0 if none)
+};
+
+}  // namespace daq
+}  // namespace mahi
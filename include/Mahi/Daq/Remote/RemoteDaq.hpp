@@ -0,0 +1,269 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Io.hpp>
+#include <Mahi/Daq/Remote/Protocol.hpp>
+#include <cstring>
+#include <memory>
+
+namespace mahi {
+namespace daq {
+
+class RemoteDaq;
+
+/// Mirrors a Module served by a DaqServer with the same name and channels. Reads and
+/// writes of the Module alone are one exchange each; RemoteDaq::read_all, write_all and
+/// write_read_all batch every Module into one.
+template <class M>
+class RemoteModule : public M {
+public:
+    /// Value type of the mirrored Buffer
+    typedef typename M::Type T;
+    /// Constructor
+    RemoteModule(RemoteDaq& d, const TraceStream& layout, std::size_t input, std::size_t output) :
+        M(d, layout.channels), m_remote(d), m_input(input), m_output(output) {
+        this->set_name(layout.module);
+        this->set_channels(layout.channels);
+    }
+
+protected:
+    friend RemoteDaq;
+    /// Reads channels with a read exchange
+    bool remote_read(const ChanNum* chs, T* values, std::size_t n);
+    /// Writes channels with a write exchange carrying this Module's values only
+    bool remote_write(const ChanNum* chs, const T* values, std::size_t n);
+    /// Copies served values into the Buffer after read_all and runs its post-read stage
+    static void receive(void* self, const char* values) {
+        RemoteModule& m = *static_cast<RemoteModule*>(self);
+        std::memcpy(&m.buffer()[0], values, m.buffer().size() * sizeof(T));
+        m.post_read.emit(&m.channels_internal()[0], &m.buffer()[0], m.channels_internal().size());
+        m.publish_snapshots();
+    }
+    /// Copies the Buffer into a write_all request
+    static void send(void* self, char* values) {
+        RemoteModule& m = *static_cast<RemoteModule*>(self);
+        std::memcpy(values, &m.buffer()[0], m.buffer().size() * sizeof(T));
+    }
+    /// Runs the post-write stage after write_all
+    static void sent(void* self) {
+        RemoteModule& m = *static_cast<RemoteModule*>(self);
+        m.post_write.emit(&m.channels_internal()[0], &m.buffer()[0], m.channels_internal().size());
+    }
+    /// Returns read_with_all
+    static bool reads_with_all(void* self) { return static_cast<RemoteModule*>(self)->read_with_all; }
+    /// Returns write_with_all
+    static bool writes_with_all(void* self) { return static_cast<RemoteModule*>(self)->write_with_all; }
+
+private:
+    RemoteDaq&     m_remote;   ///< the owning RemoteDaq
+    std::size_t    m_input;    ///< index of the served input stream
+    std::size_t    m_output;   ///< index of the served output stream
+    std::vector<T> m_scratch;  ///< values of remote_write
+};
+
+/// Remote analog inputs
+class RemoteAI : public RemoteModule<AIModule> {
+public:
+    RemoteAI(RemoteDaq& d, const TraceStream& layout, std::size_t input);
+private:
+    bool read_impl(const ChanNum* chs, Volts* vals, std::size_t n) { return remote_read(chs, vals, n); }
+};
+
+/// Remote analog (or PWM) outputs
+class RemoteAO : public RemoteModule<AOModule> {
+public:
+    RemoteAO(RemoteDaq& d, const TraceStream& layout, std::size_t output);
+private:
+    bool write_impl(const ChanNum* chs, const Volts* vals, std::size_t n) { return remote_write(chs, vals, n); }
+};
+
+/// Remote digital inputs
+class RemoteDI : public RemoteModule<DIModule> {
+public:
+    RemoteDI(RemoteDaq& d, const TraceStream& layout, std::size_t input);
+private:
+    bool read_impl(const ChanNum* chs, TTL* vals, std::size_t n) { return remote_read(chs, vals, n); }
+};
+
+/// Remote digital outputs
+class RemoteDO : public RemoteModule<DOModule> {
+public:
+    RemoteDO(RemoteDaq& d, const TraceStream& layout, std::size_t output);
+private:
+    bool write_impl(const ChanNum* chs, const TTL* vals, std::size_t n) { return remote_write(chs, vals, n); }
+};
+
+/// Remote encoders. Writes (e.g. zeroing) are supported if the server serves the counts as an output.
+class RemoteEncoder : public RemoteModule<EncoderModule> {
+public:
+    RemoteEncoder(RemoteDaq& d, const TraceStream& layout, std::size_t input, std::size_t output);
+private:
+    bool read_impl(const ChanNum* chs, Counts* vals, std::size_t n) { return remote_read(chs, vals, n); }
+    bool write_impl(const ChanNum* chs, const Counts* vals, std::size_t n) { return remote_write(chs, vals, n); }
+};
+
+/// A Daq on another machine, served by a DaqServer over UDP. The served Modules are mirrored
+/// with their names and channels when the RemoteDaq is constructed: inputs of double, TTL and
+/// Counts become AI, DI and encoder Modules, outputs of double and TTL become AO and DO Modules.
+/// read_all, write_all and write_read_all are one request/reply exchange each, carrying a
+/// full cycle of outputs and/or inputs, a sequence number and latency stamps. Lost datagrams
+/// are retransmitted after the timeout (see set_timeout).
+///
+/// RemoteDaq rio("192.168.1.10");
+/// auto ai = rio.AI();
+/// auto ao = rio.AO();
+/// while (running) {
+///     rio.write_read_all();  // last cycle's outputs out, this cycle's inputs in
+///     ao->set(controller(ai->get()));
+/// }
+class RemoteDaq : public Daq {
+public:
+    /// Constructor. Connects to the DaqServer at host:port and mirrors its Modules. Opens
+    /// automatically if #auto_open is true.
+    RemoteDaq(const std::string& host, unsigned short port = RemotePort, bool auto_open = true);
+    /// Destructor. First disables if enabled, then closes if open.
+    ~RemoteDaq();
+    /// Returns true if the server answered and its Modules were mirrored
+    bool is_connected() const;
+    /// Reads all inputs in a single exchange
+    bool read_all() override;
+    /// Writes all outputs in a single exchange
+    bool write_all() override;
+    /// Writes all outputs, then reads all inputs, in a single exchange
+    bool write_read_all() override;
+    /// Sets how long to wait for a reply before retransmitting, and how many times to retransmit
+    void set_timeout(util::Time timeout, int retries = 3);
+    /// Returns the number of completed exchanges
+    std::uint64_t exchanges() const;
+    /// Returns the number of retransmitted requests
+    std::uint64_t retransmissions() const;
+    /// Returns the round trip time of the last exchange
+    util::Time round_trip() const;
+    /// Returns the time the server spent on its Daq in the last exchange. The rest of
+    /// round_trip is network and protocol overhead.
+    util::Time server_time() const;
+    /// Returns the histogram of round trip times. Empty unless mahi::daq was built with
+    /// MAHI_DAQ_METRICS (see Metrics.hpp).
+    LatencyHistogram& round_trip_latency() { return m_round_trip_latency; }
+
+    /// Returns the mirrored analog input Module named name (the first if name is empty), or nullptr
+    AIModule* AI(const std::string& name = "") const { return find<RemoteAI>(name); }
+    /// Returns the mirrored analog output Module named name (the first if name is empty), or nullptr
+    AOModule* AO(const std::string& name = "") const { return find<RemoteAO>(name); }
+    /// Returns the mirrored digital input Module named name (the first if name is empty), or nullptr
+    DIModule* DI(const std::string& name = "") const { return find<RemoteDI>(name); }
+    /// Returns the mirrored digital output Module named name (the first if name is empty), or nullptr
+    DOModule* DO(const std::string& name = "") const { return find<RemoteDO>(name); }
+    /// Returns the mirrored encoder Module named name (the first if name is empty), or nullptr
+    EncoderModule* encoder(const std::string& name = "") const { return find<RemoteEncoder>(name); }
+
+protected:
+    /// Fails if the server did not answer. Overrides Daq::on_daq_open.
+    bool on_daq_open() override;
+
+private:
+    template <class M> friend class RemoteModule;
+    /// A served stream and the mirrored Module it belongs to (module is nullptr if not mirrored)
+    struct Link {
+        void*       module;                   ///< the RemoteModule
+        std::size_t offset;                   ///< offset of the values in a State payload (inputs)
+        std::size_t bytes;                    ///< size of the values
+        void (*receive)(void*, const char*);  ///< see RemoteModule::receive
+        void (*send)(void*, char*);           ///< see RemoteModule::send
+        void (*sent)(void*);                  ///< see RemoteModule::sent
+        bool (*with_all)(void*);              ///< see RemoteModule::reads_with_all/writes_with_all
+    };
+    /// Requests and mirrors the server's streams
+    bool describe();
+    /// Registers module as the mirror of input stream i
+    template <class R>
+    void link_input(R* module, std::size_t i) {
+        m_inputs[i].module   = module;
+        m_inputs[i].receive  = &R::receive;
+        m_inputs[i].with_all = &R::reads_with_all;
+    }
+    /// Registers module as the mirror of output stream i
+    template <class R>
+    void link_output(R* module, std::size_t i) {
+        m_outputs[i].module   = module;
+        m_outputs[i].send     = &R::send;
+        m_outputs[i].sent     = &R::sent;
+        m_outputs[i].with_all = &R::writes_with_all;
+    }
+    /// Writes the Cycle payload into m_tx: if all is true, every output whose Module writes
+    /// with write_all, otherwise output stream only with values. Returns the payload size.
+    std::size_t pack(bool all, std::size_t only, const void* values);
+    /// Sends a request with payload bytes already in m_tx and waits for the reply in m_rx
+    bool exchange(RemoteMessage type, std::uint8_t flags, std::size_t payload);
+    /// Reads all inputs and returns the values of input stream i, or nullptr on failure
+    const char* fetch(std::size_t i);
+    /// Writes values to output stream i alone
+    bool push(std::size_t i, const void* values);
+    /// Runs the post-read stage of every mirrored input read with read_all
+    void received();
+    /// Returns the owned Module of type M named name
+    template <class M>
+    M* find(const std::string& name) const {
+        for (auto& m : m_mirrored) {
+            M* match = dynamic_cast<M*>(m.get());
+            if (match && (name.empty() || match->name() == name))
+                return match;
+        }
+        return nullptr;
+    }
+
+private:
+    UdpSocket                                     m_socket;             ///< the client socket
+    bool                                          m_connected;          ///< see is_connected
+    std::vector<TraceStream>                      m_schema;             ///< the served streams
+    std::vector<Link>                             m_inputs;             ///< served input streams
+    std::vector<Link>                             m_outputs;            ///< served output streams
+    std::size_t                                   m_in_bytes;           ///< size of a State payload
+    std::vector<std::unique_ptr<ChanneledModule>> m_mirrored;           ///< the mirrored Modules
+    std::vector<char>                             m_tx;                 ///< request buffer
+    std::vector<char>                             m_rx;                 ///< reply buffer
+    std::uint32_t                                 m_seq;                ///< sequence number of the last request
+    util::Time                                    m_timeout;            ///< see set_timeout
+    int                                           m_retries;            ///< see set_timeout
+    std::uint64_t                                 m_exchanges;          ///< see exchanges
+    std::uint64_t                                 m_retransmissions;    ///< see retransmissions
+    std::int64_t                                  m_round_trip_ns;      ///< see round_trip
+    std::int64_t                                  m_server_ns;          ///< see server_time
+    LatencyHistogram                              m_round_trip_latency; ///< see round_trip_latency
+};
+
+template <class M>
+bool RemoteModule<M>::remote_read(const ChanNum* chs, T* values, std::size_t n) {
+    const char* served = m_remote.fetch(m_input);
+    if (!served)
+        return false;
+    for (std::size_t i = 0; i < n; ++i)
+        std::memcpy(&values[i], served + this->channel_index(chs[i]) * sizeof(T), sizeof(T));
+    return true;
+}
+
+template <class M>
+bool RemoteModule<M>::remote_write(const ChanNum* chs, const T* values, std::size_t n) {
+    m_scratch.assign(this->buffer().begin(), this->buffer().end());
+    for (std::size_t i = 0; i < n; ++i)
+        m_scratch[this->channel_index(chs[i])] = values[i];
+    return m_remote.push(m_output, m_scratch.data());
+}
+
+} // namespace daq
+} // namespace mahi
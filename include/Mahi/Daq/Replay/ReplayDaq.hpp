@@ -0,0 +1,233 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Io.hpp>
+#include <Mahi/Daq/Trace.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <memory>
+
+namespace mahi {
+namespace daq {
+
+class ReplayDaq;
+
+/// Walks the records of one traced stream
+class ReplayCursor {
+public:
+    /// Constructor
+    ReplayCursor(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records);
+    /// Returns to the first record
+    void rewind() { m_cursor = 0; }
+    /// Returns true once every record has been consumed
+    bool finished() const { return m_cursor >= m_records.size(); }
+protected:
+    ReplayDaq&                              m_daq;       ///< the owning ReplayDaq
+    const std::vector<TraceReader::Record>& m_records;   ///< the stream's records
+    std::size_t                             m_cursor;    ///< the next record
+    ChanMap                                 m_map;       ///< recorded internal channel -> index
+};
+
+/// Serves the recorded values of an input stream, one record per read. Channels that a
+/// record does not contain (e.g. after an immediate single channel read) keep the value
+/// they were last served.
+template <typename T>
+class ReplaySource : public ReplayCursor {
+public:
+    /// Constructor
+    ReplaySource(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records);
+    /// Serves the next record. Returns false once the stream is exhausted.
+    bool read(const ChanNum* chs, T* values, std::size_t n);
+private:
+    std::vector<T> m_last;  ///< last served value by index
+};
+
+/// Compares the writes of a replayed session with the recorded writes of an output stream
+template <typename T>
+class ReplaySink : public ReplayCursor {
+public:
+    /// Constructor
+    ReplaySink(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records);
+    /// Compares a write with the next record. Always succeeds; differences are counted by the ReplayDaq.
+    bool write(const ChanNum* chs, const T* values, std::size_t n);
+};
+
+/// Recreates a recorded Module with its recorded name and channels, mapping public channels
+/// to the same internal channels they had on the recorded DAQ
+template <class M>
+class ReplayModule : public M {
+public:
+    /// Constructor
+    ReplayModule(ReplayDaq& d, const TraceStream& layout) :
+        M(d, layout.channels), m_layout(layout) {
+        this->set_name(layout.module);
+        this->set_channels(layout.channels);
+    }
+protected:
+    /// Returns the recorded internal channel. Overrides ChanneledModule::convert_channel.
+    ChanNum convert_channel(ChanNum public_facing) const override {
+        for (std::size_t i = 0; i < m_layout.channels.size(); ++i) {
+            if (m_layout.channels[i] == public_facing)
+                return m_layout.internal[i];
+        }
+        return public_facing;
+    }
+private:
+    const TraceStream& m_layout;  ///< the recorded channels
+};
+
+/// Replayed analog inputs
+class ReplayAI : public ReplayModule<AIModule> {
+public:
+    ReplayAI(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records);
+    ReplaySource<Volts> source;
+private:
+    bool read_impl(const ChanNum* chs, Volts* vals, std::size_t n) { return source.read(chs, vals, n); }
+};
+
+/// Replayed analog (or PWM) outputs
+class ReplayAO : public ReplayModule<AOModule> {
+public:
+    ReplayAO(ReplayDaq& d, const TraceStream& out, const std::vector<TraceReader::Record>& records);
+    ReplaySink<Volts> sink;
+private:
+    bool write_impl(const ChanNum* chs, const Volts* vals, std::size_t n) { return sink.write(chs, vals, n); }
+};
+
+/// Replayed digital inputs
+class ReplayDI : public ReplayModule<DIModule> {
+public:
+    ReplayDI(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records);
+    ReplaySource<TTL> source;
+private:
+    bool read_impl(const ChanNum* chs, TTL* vals, std::size_t n) { return source.read(chs, vals, n); }
+};
+
+/// Replayed digital outputs
+class ReplayDO : public ReplayModule<DOModule> {
+public:
+    ReplayDO(ReplayDaq& d, const TraceStream& out, const std::vector<TraceReader::Record>& records);
+    ReplaySink<TTL> sink;
+private:
+    bool write_impl(const ChanNum* chs, const TTL* vals, std::size_t n) { return sink.write(chs, vals, n); }
+};
+
+/// Replayed encoders. Count writes (e.g. zeroing) are compared like other outputs.
+class ReplayEncoder : public ReplayModule<EncoderModule> {
+public:
+    ReplayEncoder(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records,
+                  const TraceStream* out, const std::vector<TraceReader::Record>* out_records);
+    ReplaySource<Counts>          source;
+    std::unique_ptr<ReplaySink<Counts>> sink;  ///< nullptr if no writes were traced
+private:
+    bool read_impl(const ChanNum* chs, Counts* vals, std::size_t n) { return source.read(chs, vals, n); }
+    bool write_impl(const ChanNum* chs, const Counts* vals, std::size_t n) { return sink ? sink->write(chs, vals, n) : true; }
+};
+
+/// A DAQ that replays a trace written by TraceWriter, so control code can be re-run and
+/// regression tested offline at full CPU speed. The recorded Modules are recreated from the
+/// trace header with their names and channel sets: Modules that were read become AI, DI or
+/// encoder Modules (by value type) and serve the recorded inputs one read at a time; Modules
+/// that were only written become AO or DO Modules and compare every write against the
+/// recorded writes, so a changed controller shows up as output mismatches. Opaque streams
+/// (e.g. ranges and quadrature modes) are not replayed.
+///
+/// ReplayDaq replay("session.mtrc");
+/// auto ai = replay.AI("q8.AI");
+/// auto ao = replay.AO("q8.AO");
+/// while (replay.read_all()) {
+///     ao->set(controller(ai->get()));
+///     replay.write_all();
+/// }
+/// print("{} mismatches", replay.output_mismatches());
+///
+/// Replay is faithful as long as the control code performs the same reads and writes in the
+/// same order as the recorded session (e.g. if the trace was opened before enable, enable
+/// the ReplayDaq too, with the same enable_values).
+class ReplayDaq : public Daq {
+public:
+    /// Constructor. Loads trace and recreates its Modules. Opens automatically if #auto_open is true.
+    ReplayDaq(const std::string& trace, bool auto_open = true);
+    /// Destructor. First disables if enabled, then closes if open.
+    ~ReplayDaq();
+    /// Returns true if the trace was loaded
+    bool is_loaded() const;
+    /// Returns true once any input stream has run out of records (its reads then fail)
+    bool finished() const;
+    /// Restarts the replay from the first record and clears the comparison results
+    void rewind();
+    /// Returns the recorded time of the last input served, relative to when the trace was opened
+    util::Time time() const;
+    /// Sets the largest difference between a written and a recorded value that is not a mismatch
+    void set_tolerance(double tolerance);
+    /// Returns the number of written channel values compared with the trace
+    std::uint64_t outputs_compared() const;
+    /// Returns the number of written channel values that did not match the trace, including
+    /// values written beyond its end or to channels the recorded write did not contain
+    std::uint64_t output_mismatches() const;
+    /// Returns the largest difference between a written and a recorded value
+    double max_output_error() const;
+
+    /// Returns the replayed analog input Module named name (the first if name is empty), or nullptr
+    AIModule* AI(const std::string& name = "") const { return find<ReplayAI>(name); }
+    /// Returns the replayed analog output Module named name (the first if name is empty), or nullptr
+    AOModule* AO(const std::string& name = "") const { return find<ReplayAO>(name); }
+    /// Returns the replayed digital input Module named name (the first if name is empty), or nullptr
+    DIModule* DI(const std::string& name = "") const { return find<ReplayDI>(name); }
+    /// Returns the replayed digital output Module named name (the first if name is empty), or nullptr
+    DOModule* DO(const std::string& name = "") const { return find<ReplayDO>(name); }
+    /// Returns the replayed encoder Module named name (the first if name is empty), or nullptr
+    EncoderModule* encoder(const std::string& name = "") const { return find<ReplayEncoder>(name); }
+
+private:
+    friend ReplayCursor;
+    template <typename T> friend class ReplaySource;
+    template <typename T> friend class ReplaySink;
+    /// Returns the owned Module of type M named name
+    template <class M>
+    M* find(const std::string& name) const {
+        for (auto& m : m_replayed) {
+            M* match = dynamic_cast<M*>(m.get());
+            if (match && (name.empty() || match->name() == name))
+                return match;
+        }
+        return nullptr;
+    }
+    /// Records the result of comparing one written value
+    void compare(double error, bool present) {
+        ++m_compared;
+        if (!present || error > m_tolerance || error != error)
+            ++m_mismatches;
+        if (present && error > m_max_error)
+            m_max_error = error;
+    }
+
+private:
+    TraceReader                                   m_trace;       ///< the loaded trace
+    bool                                          m_loaded;      ///< see is_loaded
+    std::vector<std::unique_ptr<ChanneledModule>> m_replayed;    ///< the recreated Modules
+    std::vector<ReplayCursor*>                    m_inputs;      ///< cursors of input streams
+    std::vector<ReplayCursor*>                    m_outputs;     ///< cursors of output streams
+    std::int64_t                                  m_time_ns;     ///< see time
+    double                                        m_tolerance;   ///< see set_tolerance
+    std::uint64_t                                 m_compared;    ///< see outputs_compared
+    std::uint64_t                                 m_mismatches;  ///< see output_mismatches
+    double                                        m_max_error;   ///< see max_output_error
+};
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Module.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// Value types that can be published to shared memory
+enum class ShmType : std::uint32_t {
+    Float64 = 0,  ///< double (e.g. Volts, positions)
+    Int32   = 1,  ///< 32-bit integer (e.g. Counts)
+    Int8    = 2,  ///< 8-bit integer (e.g. TTL)
+};
+
+/// Describes one published channel
+struct ShmChannel {
+    std::string module;   ///< the Module's name, e.g. "q8.AI"
+    ChanNum     channel;  ///< the public channel number
+    ShmType     type;     ///< the value type
+    std::size_t offset;   ///< byte offset of the value within the data block
+};
+
+/// Publishes selected Buffers of a Daq into a named POSIX shared memory segment so that
+/// other processes (visualizers, loggers, safety monitors) can observe the loop at full
+/// rate. Each cycle the real-time thread calls #publish, which copies the Buffers into the
+/// segment under a seqlock: it never blocks on readers and never allocates. Read the
+/// segment from another process with ShmReader.
+///
+/// ShmPublisher pub("q8_state");
+/// pub.add(q8.AI);
+/// pub.add(q8.encoder);
+/// pub.open();
+/// thread.update = [&](Time t) { ...; pub.publish(t); };
+///
+/// Segment layout (native byte order): the 8 byte magic "MAHISHM1", uint32 channel count,
+/// uint32 data size, the uint64 seqlock sequence (odd while being written), then per
+/// channel a 64 byte module name, uint32 channel number, uint32 type and uint32 offset;
+/// then, 64 byte aligned, the data block of uint64 cycle, int64 time in [us] and the values.
+class ShmPublisher : util::NonCopyable {
+public:
+    /// Constructor. name identifies the segment, e.g. "q8_state" (see ShmReader).
+    ShmPublisher(const std::string& name);
+    /// Destructor. Closes the segment if open.
+    ~ShmPublisher();
+    /// Adds every current channel of any IGet Buffer of double, Counts or TTL. Set channels
+    /// and add Buffers before open, and do not change channels while open.
+    template <typename B>
+    bool add(const B& buffer) {
+        typedef typename B::Type T;
+        return add_buffer(&buffer, &ShmPublisher::copy_values<B>, buffer.module(), type_of(static_cast<const T*>(nullptr)), sizeof(T));
+    }
+    /// Creates the segment and writes its schema. Returns false on failure or on platforms
+    /// without POSIX shared memory.
+    bool open();
+    /// Unmaps and removes the segment
+    void close();
+    /// Returns true if the segment is open
+    bool is_open() const;
+    /// Copies the current values of every added Buffer into the segment, stamped with time t
+    /// and the next cycle number. Wait-free and allocation-free; call from the real-time
+    /// thread once per cycle. Returns false if the segment is not open.
+    bool publish(util::Time t);
+    /// Returns the number of cycles published
+    std::uint64_t published() const;
+    /// Returns the published channels
+    const std::vector<ShmChannel>& channels() const;
+
+private:
+    /// Copies all values of Buffer B to dst
+    template <typename B>
+    static void copy_values(const void* buffer, void* dst, std::size_t bytes);
+    /// Value type codes
+    static ShmType type_of(const double*) { return ShmType::Float64; }
+    static ShmType type_of(const std::int32_t*) { return ShmType::Int32; }
+    static ShmType type_of(const char*) { return ShmType::Int8; }
+    /// Type erased implementation of add
+    bool add_buffer(const void* buffer, void (*copy)(const void*, void*, std::size_t),
+                    const ChanneledModule& module, ShmType type, std::size_t size);
+
+private:
+    /// An added Buffer
+    struct Source {
+        const void* buffer;                             ///< the Buffer
+        void        (*copy)(const void*, void*, std::size_t); ///< type restoring copy
+        std::size_t offset;                             ///< byte offset in the data block
+        std::size_t bytes;                              ///< byte size of the values
+    };
+    std::string             m_name;       ///< segment name
+    std::vector<Source>     m_sources;    ///< added Buffers
+    std::vector<ShmChannel> m_channels;   ///< published channels
+    std::size_t             m_data_size;  ///< size of the data block in bytes
+    void*                   m_segment;    ///< the mapped segment (nullptr if closed)
+    std::size_t             m_size;       ///< size of the mapped segment in bytes
+    unsigned char*          m_data;       ///< the data block within the segment
+    std::atomic<std::uint64_t>* m_sequence; ///< the seqlock sequence within the segment
+    std::uint64_t           m_cycle;      ///< see published
+};
+
+/// Reads a segment published by an ShmPublisher in another (or the same) process. Each
+/// update copies one consistent cycle out of the segment without ever blocking the
+/// publisher; values are then queried by channel index (see channels).
+///
+/// ShmReader reader;
+/// if (reader.open("q8_state")) {
+///     while (...) { if (reader.update()) print("{}", reader.value(0)); }
+/// }
+class ShmReader : util::NonCopyable {
+public:
+    /// Constructor
+    ShmReader();
+    /// Destructor. Closes the segment if open.
+    ~ShmReader();
+    /// Maps the segment published under name and reads its schema. Returns false if no such
+    /// segment exists or it is not a mahi::daq segment.
+    bool open(const std::string& name);
+    /// Unmaps the segment
+    void close();
+    /// Returns true if a segment is open
+    bool is_open() const;
+    /// Copies the latest consistent cycle out of the segment. Returns true if it is newer than
+    /// the previous one, false if nothing new was published (or the segment is not open).
+    bool update();
+    /// Returns the cycle number of the last update
+    std::uint64_t cycle() const;
+    /// Returns the publisher's time stamp of the last update
+    util::Time time() const;
+    /// Returns the published channels
+    const std::vector<ShmChannel>& channels() const;
+    /// Returns the value of channel i (see channels) from the last update as a double
+    double value(std::size_t i) const;
+    /// Returns the index of a Module's channel (e.g. "q8.AI", 0), or -1 if it is not published
+    int find(const std::string& module, ChanNum ch) const;
+
+private:
+    void*                             m_segment;   ///< the mapped segment (nullptr if closed)
+    std::size_t                       m_size;      ///< size of the mapped segment in bytes
+    const unsigned char*              m_data;      ///< the data block within the segment
+    const std::atomic<std::uint64_t>* m_sequence;  ///< the seqlock sequence within the segment
+    std::vector<ShmChannel>           m_channels;  ///< published channels
+    std::vector<unsigned char>        m_frame;     ///< copy of the data block from the last update
+};
+
+template <typename B>
+void ShmPublisher::copy_values(const void* buffer, void* dst, std::size_t bytes) {
+    auto& values = static_cast<const B*>(buffer)->get();
+    std::size_t n = values.size() * sizeof(typename B::Type);
+    std::memcpy(dst, values.data(), n < bytes ? n : bytes);
+}
+
+}  // namespace daq
+}  // namespace mahi
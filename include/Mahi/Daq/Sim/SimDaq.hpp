@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Daq/Io.hpp>
+#include <Mahi/Daq/Streaming.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+
+namespace mahi {
+namespace daq {
+
+class SimDaq;
+
+/// The time one simulated device transaction takes. Latencies are drawn from a normal
+/// distribution clamped at zero. They are spent busy-waiting like a polled register access,
+/// or, if blocking, sleeping like a driver call waiting on a bus transfer (which frees the
+/// CPU for other threads but adds the OS's wake-up latency).
+struct SimLatency {
+    /// Constructor
+    SimLatency(double mean_us = 0, double jitter_us = 0, bool blocking = false) :
+        mean_us(mean_us), jitter_us(jitter_us), blocking(blocking) {}
+    double mean_us;    ///< mean latency in [us]
+    double jitter_us;  ///< standard deviation of the latency in [us]
+    bool   blocking;   ///< sleep rather than busy-wait
+    /// No latency, for measuring the framework alone
+    static SimLatency None() { return SimLatency(0, 0); }
+    /// A USB DAQ (e.g. Quanser Q8-USB), ~125 us per blocking transaction with noticeable jitter
+    static SimLatency Usb() { return SimLatency(125, 15, true); }
+    /// A PCIe DAQ (e.g. Sensoray 826), ~2 us per transaction
+    static SimLatency Pcie() { return SimLatency(2, 0.3); }
+};
+
+/// Simulated analog inputs, wired in loopback to the SimDaq's analog outputs
+class SimAI : public AIModule {
+public:
+    SimAI(SimDaq& d, const ChanNums& allowed);
+private:
+    bool read_impl(const ChanNum* chs, Volts* vals, std::size_t n);
+    SimDaq& m_daq;
+};
+
+/// Simulated analog outputs
+class SimAO : public AOModule {
+public:
+    SimAO(SimDaq& d, const ChanNums& allowed);
+private:
+    bool write_impl(const ChanNum* chs, const Volts* vals, std::size_t n);
+    SimDaq& m_daq;
+};
+
+/// Simulated digital inputs, wired in loopback to the SimDaq's digital outputs
+class SimDI : public DIModule {
+public:
+    SimDI(SimDaq& d, const ChanNums& allowed);
+private:
+    bool read_impl(const ChanNum* chs, TTL* vals, std::size_t n);
+    SimDaq& m_daq;
+};
+
+/// Simulated digital outputs
+class SimDO : public DOModule {
+public:
+    SimDO(SimDaq& d, const ChanNums& allowed);
+private:
+    bool write_impl(const ChanNum* chs, const TTL* vals, std::size_t n);
+    SimDaq& m_daq;
+};
+
+/// Simulated encoders. Every read advances each channel's counts by its #increments value.
+class SimEncoder : public EncoderModule {
+public:
+    SimEncoder(SimDaq& d, const ChanNums& allowed);
+    /// Counts added to each channel on every read (0 by default)
+    SettableBuffer<Counts> increments;
+private:
+    bool read_impl(const ChanNum* chs, Counts* vals, std::size_t n);
+    bool write_impl(const ChanNum* chs, const Counts* vals, std::size_t n);
+    SimDaq&             m_daq;
+    std::vector<Counts> m_counts;
+};
+
+/// Simulated hardware-timed analog input stream, sampling the same AO loopback wires as
+/// SimAI. Scans are "acquired" by the clock at the sample rate; if they are not read
+/// within buffer_size scans, the oldest are lost as on a real device.
+class SimStreamingAI : public StreamingAIModule {
+public:
+    SimStreamingAI(SimDaq& d, const ChanNums& allowed);
+protected:
+    bool on_stream_start(const ChanNums& chs, double hz, std::size_t buffer_scans) override;
+    bool on_stream_stop() override;
+    std::size_t on_read_block(Volts* samples, std::size_t max_scans, std::uint64_t& lost) override;
+private:
+    SimDaq&                               m_daq;
+    ChanNums                              m_chs;       ///< streamed internal channels
+    double                                m_rate;      ///< sample rate in [Hz]
+    std::size_t                           m_capacity;  ///< buffered scans before overrun
+    std::chrono::steady_clock::time_point m_start;     ///< when the stream started
+    std::uint64_t                         m_consumed;  ///< scans read or lost so far
+};
+
+/// A software-only DAQ for benchmarking and testing without hardware. It has eight
+/// channels of each of AI, AO, DI, DO and encoder. AO channel i is wired to AI channel i,
+/// and DO channel i to DI channel i, so loopback tests (e.g. ex_perf) run anywhere.
+/// Every device transaction takes a configurable SimLatency. read_all, write_all and
+/// write_read_all are one transaction each, as on DAQs with synced I/O (e.g. QuanserDaq);
+/// reading or writing a single Module is one transaction too, as are the reads and the writes
+/// of a pipelined cycle (see Daq::set_pipelined). A hardware-timed AI stream is also provided.
+class SimDaq : public Daq {
+// the device state is declared before the Modules, so that it outlives a pipelined transfer
+// still in flight when they are destroyed (see ~IRead)
+private:
+    SimLatency                       m_latency;  ///< latency of each transaction
+    std::mt19937                     m_rng;      ///< jitter generator
+    std::normal_distribution<double> m_jitter;   ///< standard normal distribution
+    std::recursive_mutex             m_mutex;    ///< held by the thread transacting with the device
+    bool                             m_synced;   ///< true inside read_all/write_all (guarded by m_mutex)
+    std::atomic<std::uint64_t>       m_transactions; ///< see transactions
+    std::vector<Volts>               m_analog;   ///< AO -> AI loopback wires
+    std::vector<TTL>                 m_digital;  ///< DO -> DI loopback wires
+
+public:
+    /// Constructor. Opens automatically if #auto_open is true.
+    SimDaq(const SimLatency& latency = SimLatency::None(), bool auto_open = true);
+    /// Destructor. First disables if enabled, then closes if open.
+    ~SimDaq();
+    /// Reads all inputs in a single transaction
+    bool read_all() override;
+    /// Writes all outputs in a single transaction
+    bool write_all() override;
+    /// Writes all outputs, then reads all inputs, in a single transaction
+    bool write_read_all() override;
+    /// Sets the latency of subsequent transactions
+    void set_latency(const SimLatency& latency);
+    /// Returns the latency of transactions
+    const SimLatency& latency() const;
+    /// Returns the number of device transactions performed since construction, e.g. to
+    /// compare how many round trips two ways of doing the same I/O would cost on hardware
+    std::uint64_t transactions() const;
+
+    /// Eight analog inputs (0-7), reading what AO last wrote on the same channel
+    SimAI AI;
+    /// Eight analog outputs (0-7)
+    SimAO AO;
+    /// Eight digital inputs (0-7), reading what DO last wrote on the same channel
+    SimDI DI;
+    /// Eight digital outputs (0-7)
+    SimDO DO;
+    /// Eight encoders (0-7)
+    SimEncoder encoder;
+    /// Hardware-timed stream of eight analog inputs (0-7), sampling the AO loopback wires
+    SimStreamingAI stream;
+
+private:
+    friend SimAI;
+    friend SimAO;
+    friend SimDI;
+    friend SimDO;
+    friend SimEncoder;
+    friend SimStreamingAI;
+    /// Performs the reads or writes of a pipelined cycle in a single transaction
+    bool transfer_all(const std::vector<CycleStep>& steps) override;
+    /// Exclusive access to the simulated device for the lifetime of a transaction
+    typedef std::unique_lock<std::recursive_mutex> Transaction;
+    /// Starts a transaction, spending its latency unless inside read_all/write_all. Threads
+    /// (e.g. the caller and the I/O worker of a pipelined cycle) take turns on the device.
+    Transaction transact();
+    /// Counts one transaction and waits for its latency
+    void wait_latency();
+};
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,77 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Util/NonCopyable.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// A seqlock protected copy of a Buffer's values. A single writer (the thread
+/// calling read/read_all) publishes new values without ever waiting, while any
+/// number of reader threads can fetch a consistent copy. Readers retry if the
+/// writer published while they were copying, so they never see torn values.
+/// T must be trivially copyable (all built in Buffer types are).
+template <typename T>
+class Snapshot : util::NonCopyable {
+public:
+    /// Constructor
+    Snapshot(std::size_t size = 0) : m_values(size), m_seq(0), m_cycle(0) {}
+    /// Resizes the snapshot storage. Not thread safe; only call while no readers are active.
+    void resize(std::size_t size) { m_values.resize(size); }
+    /// Publishes new values tagged with a cycle number. n must equal the snapshot size.
+    /// Must only be called from one thread.
+    void publish(const T* values, std::size_t n, std::uint64_t cycle) {
+        std::uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::copy(values, values + std::min(n, m_values.size()), m_values.begin());
+        m_cycle = cycle;
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+    /// Copies the most recently published values into out and optionally returns the cycle
+    /// number they were published on. Returns false if nothing has been published yet.
+    bool fetch(std::vector<T>& out, std::uint64_t* cycle = nullptr) const {
+        for (;;) {
+            std::uint64_t seq0 = m_seq.load(std::memory_order_acquire);
+            if (seq0 & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            out.assign(m_values.begin(), m_values.end());
+            std::uint64_t c = m_cycle;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == seq0) {
+                if (cycle)
+                    *cycle = c;
+                return seq0 != 0;
+            }
+        }
+    }
+
+private:
+    std::vector<T>             m_values;  ///< published values
+    std::atomic<std::uint64_t> m_seq;     ///< sequence number, odd while a publish is in progress
+    std::uint64_t              m_cycle;   ///< cycle number of the published values
+};
+
+}  // namespace daq
+}  // namespace mahi
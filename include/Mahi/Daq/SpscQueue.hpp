@@ -0,0 +1,88 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Util/NonCopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// A bounded, wait-free, single-producer/single-consumer queue. Exactly one thread
+/// may push and exactly one (other) thread may pop. All storage is allocated up
+/// front, so neither push nor pop allocate, block, or spin.
+template <typename T>
+class SpscQueue : util::NonCopyable {
+public:
+    /// Constructor. The queue holds up to capacity elements.
+    SpscQueue(std::size_t capacity) : m_slots(capacity + 1), m_head(0), m_tail(0) {}
+    /// Pushes a copy of value. Returns false (and drops value) if the queue is full.
+    bool push(const T& value) {
+        std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        std::size_t next = increment(tail);
+        if (next == m_head.load(std::memory_order_acquire))
+            return false;
+        m_slots[tail] = value;
+        m_tail.store(next, std::memory_order_release);
+        return true;
+    }
+    /// Pops the oldest value into value. Returns false if the queue is empty.
+    bool pop(T& value) {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return false;
+        value = m_slots[head];
+        m_head.store(increment(head), std::memory_order_release);
+        return true;
+    }
+    /// Returns a pointer to the oldest value without popping it, or nullptr if the queue is
+    /// empty. Only the consumer thread may call this.
+    T* front() {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+            return nullptr;
+        return &m_slots[head];
+    }
+    /// Pops the oldest value, if any. Only the consumer thread may call this.
+    void pop() {
+        std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head != m_tail.load(std::memory_order_acquire))
+            m_head.store(increment(head), std::memory_order_release);
+    }
+    /// Returns the approximate number of queued values
+    std::size_t size() const {
+        std::size_t head = m_head.load(std::memory_order_acquire);
+        std::size_t tail = m_tail.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : m_slots.size() - head + tail;
+    }
+    /// Returns true if the queue is (approximately) empty
+    bool empty() const { return size() == 0; }
+    /// Returns the maximum number of values the queue can hold
+    std::size_t capacity() const { return m_slots.size() - 1; }
+
+private:
+    std::size_t increment(std::size_t i) const { return i + 1 == m_slots.size() ? 0 : i + 1; }
+
+private:
+    std::vector<T>                       m_slots;  ///< ring storage (one slot always empty)
+    alignas(64) std::atomic<std::size_t> m_head;   ///< next slot to pop (owned by consumer)
+    alignas(64) std::atomic<std::size_t> m_tail;   ///< next slot to push (owned by producer)
+};
+
+}  // namespace daq
+}  // namespace mahi
@@ -0,0 +1,185 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Module.hpp>
+#include <Mahi/Daq/Daq.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <Mahi/Util/Timing/Time.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+/// A block of hardware-timed samples drained from a StreamingInputModule. Samples are
+/// interleaved by scan: all channels of scan 0, then all channels of scan 1, etc.
+/// Allocate blocks up front and reuse them; reading into a block never allocates.
+template <typename T>
+struct StreamBlock {
+    /// Constructor. Preallocates storage for max_scans scans of num_channels channels.
+    StreamBlock(std::size_t max_scans, std::size_t num_channels) :
+        data(max_scans * num_channels), max_scans(max_scans), channels(num_channels),
+        scans(0), first_scan(0), timestamp(util::Time::Zero), overrun(false) {}
+    /// Returns the sample of scan s and the i-th channel of the stream
+    inline const T& operator()(std::size_t s, std::size_t i) const { return data[s * channels + i]; }
+    std::vector<T> data;        ///< interleaved samples
+    std::size_t    max_scans;   ///< the number of scans the block can hold
+    std::size_t    channels;    ///< the number of channels per scan
+    std::size_t    scans;       ///< the number of valid scans
+    std::uint64_t  first_scan;  ///< index of the first scan since the stream started
+    util::Time     timestamp;   ///< nominal time of the first scan since the stream started, i.e.
+                                ///< first_scan / sample_rate (not read from the hardware clock)
+    bool           overrun;     ///< true if scans were lost between the previous block and this one
+};
+
+/// An input Module that acquires hardware-timed samples at a fixed rate into a buffer
+/// owned by the backend (e.g. a HIL task buffer or a FIFO), instead of one sample per
+/// read like InputModule. Configure the rate and channels, start the stream, then drain
+/// whole blocks with #read. set_channels is refused from start until stop. Backends implement the on_stream_start, on_stream_stop and
+/// on_read_block hooks (see SimStreamingAI for an example).
+///
+/// daq.stream.set_channels({0, 1});
+/// daq.stream.set_sample_rate(10000);
+/// StreamBlock<Volts> block(1000, 2);
+/// daq.stream.start();
+/// while (...) {
+///     daq.stream.read(block);   // one round trip for up to 1000 scans
+///     ...
+/// }
+template <typename T>
+class StreamingInputModule : public ChanneledModule {
+public:
+    /// Constructor
+    StreamingInputModule(Daq& daq, const ChanNums& allowed) :
+        ChanneledModule(daq, allowed), m_rate(1000), m_buffer_scans(10000), m_streaming(false),
+        m_channels(0), m_next_scan(0), m_overruns(0) {}
+    /// Destructor
+    virtual ~StreamingInputModule() {}
+    /// Sets the sample rate in [Hz]. The stream must be stopped.
+    bool set_sample_rate(double hz) {
+        if (!can_configure() || hz <= 0)
+            return false;
+        m_rate = hz;
+        return true;
+    }
+    /// Returns the sample rate in [Hz]
+    double sample_rate() const { return m_rate; }
+    /// Sets how many scans the backend buffers between reads before overrunning. The
+    /// stream must be stopped.
+    bool set_buffer_size(std::size_t scans) {
+        if (!can_configure() || scans == 0)
+            return false;
+        m_buffer_scans = scans;
+        return true;
+    }
+    /// Returns how many scans the backend buffers between reads
+    std::size_t buffer_size() const { return m_buffer_scans; }
+    /// Starts streaming the current channels at the current sample rate
+    bool start() {
+        if (m_streaming) {
+            LOG(Warning) << name() << " is already streaming.";
+            return true;
+        }
+        if (!daq().is_enabled()) {
+            LOG(Error) << "Cannot start " << name() << " because DAQ " << daq().name() << " is not enabled.";
+            return false;
+        }
+        if (channels_internal().empty()) {
+            LOG(Error) << "Cannot start " << name() << " because it has no channels.";
+            return false;
+        }
+        if (!on_stream_start(channels_internal(), m_rate, m_buffer_scans))
+            return false;
+        m_streaming = true;
+        m_channels  = channels_internal().size();
+        m_next_scan = 0;
+        m_overruns  = 0;
+        return true;
+    }
+    /// Stops streaming
+    bool stop() {
+        if (!m_streaming)
+            return true;
+        m_streaming = false;
+        return on_stream_stop();
+    }
+    /// Returns true if the stream is running
+    bool is_streaming() const { return m_streaming; }
+    /// Drains up to block.max_scans of the scans acquired since the last read into block,
+    /// with a single backend call. block.scans may be 0 if none are available yet. Returns
+    /// false if the stream is not running, the block does not match the channel count, or
+    /// the backend fails.
+    bool read(StreamBlock<T>& block) {
+        block.scans = 0;
+        if (!m_streaming || block.channels != m_channels)
+            return false;
+        std::uint64_t lost = 0;
+        std::size_t scans = on_read_block(block.data.data(), block.max_scans, lost);
+        if (scans == static_cast<std::size_t>(-1))
+            return false;
+        m_next_scan += lost;
+        block.scans      = scans;
+        block.first_scan = m_next_scan;
+        block.timestamp  = util::microseconds(static_cast<std::int64_t>(1e6 * m_next_scan / m_rate));
+        block.overrun    = lost > 0;
+        m_overruns      += lost;
+        m_next_scan     += scans;
+        return true;
+    }
+    /// Returns the number of scans lost to overruns since the stream started
+    std::uint64_t overruns() const { return m_overruns; }
+    /// Returns the number of scans acquired (read or lost) since the stream started
+    std::uint64_t scans_acquired() const { return m_next_scan; }
+
+protected:
+    /// Called to start the backend acquiring chs (internal channel numbers) at rate hz,
+    /// buffering up to buffer_scans scans. Return true on success.
+    virtual bool on_stream_start(const ChanNums& chs, double hz, std::size_t buffer_scans) = 0;
+    /// Called to stop the backend. Return true on success.
+    virtual bool on_stream_stop() = 0;
+    /// Called to copy up to max_scans of the oldest buffered scans, interleaved, into
+    /// samples. Set lost to the number of scans the backend discarded since the previous
+    /// call because its buffer was full. Return the number of scans copied, or
+    /// static_cast<std::size_t>(-1) on failure.
+    virtual std::size_t on_read_block(T* samples, std::size_t max_scans, std::uint64_t& lost) = 0;
+    /// Stops streaming when the DAQ disables
+    bool on_daq_disable() override { return stop(); }
+    /// Refuses channel changes while streaming
+    bool on_set_channels(const ChanNums& chs) override { return can_configure(); }
+
+private:
+    /// Returns true if the stream is stopped, logs an error otherwise
+    bool can_configure() const {
+        if (m_streaming)
+            LOG(Error) << "Cannot reconfigure " << name() << " while it is streaming.";
+        return !m_streaming;
+    }
+
+private:
+    double        m_rate;          ///< sample rate in [Hz]
+    std::size_t   m_buffer_scans;  ///< backend buffer size in scans
+    bool          m_streaming;     ///< true while started
+    std::size_t   m_channels;      ///< number of channels streamed since start
+    std::uint64_t m_next_scan;     ///< index of the next scan to be read
+    std::uint64_t m_overruns;      ///< scans lost since start
+};
+
+/// Convenience type for hardware-timed analog input streams
+typedef StreamingInputModule<Volts> StreamingAIModule;
+
+}  // namespace daq
+}  // namespace mahi
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#pragma once
+#include <Mahi/Daq/Types.hpp>
+#include <Mahi/Util/NonCopyable.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace mahi {
+namespace daq {
+
+class Daq;
+class ChanneledModule;
+
+/// Value types distinguished in traces
+enum class TraceType : std::uint8_t {
+    Float64 = 0,  ///< double (e.g. Volts)
+    Int32   = 1,  ///< 32-bit integer (e.g. Counts)
+    Int8    = 2,  ///< 8-bit integer (e.g. TTL)
+    Opaque  = 3   ///< anything else (e.g. Range, QuadMode), recorded as raw bytes
+};
+
+/// Returns the TraceType of T
+template <typename T> inline TraceType trace_type() { return TraceType::Opaque; }
+template <> inline TraceType trace_type<double>() { return TraceType::Float64; }
+template <> inline TraceType trace_type<std::int32_t>() { return TraceType::Int32; }
+template <> inline TraceType trace_type<char>() { return TraceType::Int8; }
+
+/// Describes one traced Buffer (a Readable or Writeable)
+struct TraceStream {
+    std::string module;    ///< the Module's name, e.g. "q8.AI"
+    bool        output;    ///< true for a Writeable, false for a Readable
+    TraceType   type;      ///< the value type
+    std::size_t size;      ///< the size of one value in bytes
+    ChanNums    channels;  ///< the public channel numbers when tracing started
+    ChanNums    internal;  ///< the matching internal channel numbers
+};
+
+/// Logs the payload of every successful physical read and write of a Daq (i.e. what
+/// on_read produced and what on_write consumed) to a binary trace, so that a session can
+/// be replayed offline with ReplayDaq. Every Readable and Writeable is hooked through its
+/// post_read/post_write stage, so read_all, write_all, immediate reads/writes and synced
+/// DAQ transactions (e.g. QuanserDaq) are all captured. Records go through a large stdio
+/// buffer, so logging is cheap, but a full buffer is flushed on the calling thread.
+///
+/// TraceWriter trace;
+/// trace.open(q8, "session.mtrc");  // after set_channels, before enable
+/// ... run ...
+/// trace.close();
+///
+/// File layout (native byte order): the 8 byte magic "MAHITRC1" and uint32 stream count;
+/// per stream a uint32 name length and the Module name, uint8 output flag, uint8 TraceType,
+/// uint16 value size, uint32 channel count, then the public and internal channel numbers as
+/// uint32; then records of uint32 stream, uint32 channel count n, int64 time since open in
+/// [ns], n uint32 internal channel numbers and n values.
+class TraceWriter : util::NonCopyable {
+public:
+    /// Constructor. buffer_size is the size of the stdio buffer in bytes.
+    TraceWriter(std::size_t buffer_size = 1 << 20);
+    /// Destructor. Closes the trace if open.
+    ~TraceWriter();
+    /// Hooks every Readable and Writeable of daq, writes the header to filename and starts
+    /// logging. Set channels first; they should not change while tracing.
+    bool open(Daq& daq, const std::string& filename);
+    /// Unhooks the Daq and closes the trace
+    void close();
+    /// Returns true if a trace is open
+    bool is_open() const;
+    /// Returns the number of records logged
+    std::uint64_t records() const;
+    /// Returns the traced streams
+    const std::vector<TraceStream>& streams() const;
+
+    /// Registers a stream and returns its id. Called by IRead/IWrite when hooked.
+    std::uint32_t add_stream(const ChanneledModule& module, bool output, TraceType type, std::size_t size);
+    /// Logs one payload of stream. Called by IRead/IWrite after successful reads/writes.
+    void log(std::uint32_t stream, const ChanNum* chs, const void* values, std::size_t n);
+
+private:
+    std::vector<TraceStream>              m_streams;  ///< traced streams
+    std::vector<char>                     m_buffer;   ///< stdio buffer
+    std::FILE*                            m_file;     ///< the open trace
+    Daq*                                  m_daq;      ///< the traced Daq
+    std::chrono::steady_clock::time_point m_start;    ///< when the trace was opened
+    std::uint64_t                         m_records;  ///< see records
+};
+
+/// Reads a trace written by TraceWriter into memory and indexes its records by stream
+class TraceReader : util::NonCopyable {
+public:
+    /// A record in the trace
+    struct Record {
+        std::uint32_t  n;         ///< number of channels
+        std::int64_t   time_ns;   ///< time since the trace was opened in [ns]
+        const ChanNum* channels;  ///< internal channel numbers
+        const void*    values;    ///< n values
+    };
+    /// Constructor
+    TraceReader() {}
+    /// Loads filename. Returns false if it cannot be read or is not a trace.
+    bool load(const std::string& filename);
+    /// Returns the traced streams
+    const std::vector<TraceStream>& streams() const { return m_streams; }
+    /// Returns the records of stream s in the order they were logged
+    const std::vector<Record>& records(std::size_t s) const { return m_records[s]; }
+
+private:
+    std::vector<TraceStream>         m_streams;  ///< traced streams
+    std::vector<std::vector<Record>> m_records;   ///< records by stream
+    std::vector<ChanNum>             m_channels;  ///< channel numbers of all records
+    std::vector<std::uint64_t>       m_values;    ///< values of all records (8 byte aligned)
+};
+
+}  // namespace daq
+}  // namespace mahi
@@ -2,6 +2,8 @@
 #include <string>
 #include <typeinfo>
 #include <vector>
+#include <initializer_list>
+#include <iterator>
 #include <map>
 #include <unordered_map>
 #include <set>
@@ -16,8 +18,95 @@ typedef unsigned int ChanNum;
 /// An array of channel numbers
 typedef std::vector<ChanNum> ChanNums;
 
-/// Maps a channel number to an array index
-typedef std::map<unsigned int, std::size_t> ChanMap;
+/// Maps a channel number to an array index with a dense lookup table spanning the
+/// smallest to largest mapped channel number, so lookups are a subtraction and a load.
+/// Offset channel spaces (e.g. channels starting at 14000) only cost their span.
+class ChanMap {
+public:
+    /// Index returned for channels that are not mapped
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+    /// Constructs an empty map
+    ChanMap() : m_base(0) {}
+    /// Maps each channel number to its position in chs. chs must be sorted and unique.
+    ChanMap(const ChanNums& chs) : m_base(0), m_chs(chs) {
+        if (chs.empty())
+            return;
+        m_base = chs.front();
+        m_table.assign(chs.back() - m_base + 1, static_cast<unsigned int>(s_absent));
+        for (std::size_t i = 0; i < chs.size(); ++i)
+            m_table[chs[i] - m_base] = static_cast<unsigned int>(i);
+    }
+    /// Returns the index of channel ch, or npos if ch is not mapped
+    inline std::size_t find(ChanNum ch) const {
+        std::size_t slot = static_cast<std::size_t>(ch - m_base);  // wraps for ch < m_base
+        if (slot < m_table.size() && m_table[slot] != s_absent)
+            return m_table[slot];
+        return npos;
+    }
+    /// Returns the index of channel ch, which must be mapped
+    inline std::size_t operator[](ChanNum ch) const { return m_table[ch - m_base]; }
+    /// Returns 1 if channel ch is mapped, 0 otherwise
+    inline std::size_t count(ChanNum ch) const { return find(ch) == npos ? 0 : 1; }
+    /// Returns the number of mapped channels
+    inline std::size_t size() const { return m_chs.size(); }
+    /// Returns the mapped channel numbers, in index order
+    inline const ChanNums& channels() const { return m_chs; }
+
+private:
+    static constexpr unsigned int s_absent = static_cast<unsigned int>(-1);  ///< sentinel
+    ChanNum                   m_base;   ///< smallest mapped channel number
+    ChanNums                  m_chs;    ///< mapped channel numbers
+    std::vector<unsigned int> m_table;  ///< index of channel m_base + i, or s_absent
+};
+
+/// A read-only view of contiguous values, constructed from a pointer and count, a
+/// std::vector, or a braced list. Used by the Buffer interfaces so that callers holding
+/// their own arrays do not have to copy them into a std::vector first.
+template <typename T>
+class Span {
+public:
+    /// Constructs an empty view
+    Span() : m_data(nullptr), m_size(0) {}
+    /// Views size values starting at data
+    Span(const T* data, std::size_t size) : m_data(data), m_size(size) {}
+    /// Views the contents of a std::vector
+    Span(const std::vector<T>& values) : m_data(values.data()), m_size(values.size()) {}
+    /// Views a braced list (only valid for the duration of the call it is passed to)
+    Span(const std::initializer_list<T>& values) : m_data(std::begin(values)), m_size(values.size()) {}
+    /// Returns a pointer to the first value
+    inline const T* data() const { return m_data; }
+    /// Returns the number of values
+    inline std::size_t size() const { return m_size; }
+    /// Returns the value at index i
+    inline const T& operator[](std::size_t i) const { return m_data[i]; }
+    /// Returns an iterator to the first value
+    inline const T* begin() const { return m_data; }
+    /// Returns an iterator past the last value
+    inline const T* end() const { return m_data + m_size; }
+
+private:
+    const T*    m_data;  ///< the first value
+    std::size_t m_size;  ///< the number of values
+};
+
+/// Storage that Modules preallocate (e.g. to their allowed channel count) for converting
+/// Buffer values inside their callbacks, so that steady-state reads and writes do not
+/// allocate. Typically captured by value in a mutable callback lambda.
+template <typename T>
+class Scratch {
+public:
+    /// Constructor, preallocates capacity values
+    Scratch(std::size_t capacity = 0) : m_data(capacity) {}
+    /// Returns storage for at least n values. Only allocates if n exceeds the capacity.
+    inline T* get(std::size_t n) {
+        if (n > m_data.size())
+            m_data.resize(n);
+        return m_data.data();
+    }
+
+private:
+    std::vector<T> m_data;  ///< the storage
+};
 
 /// Represents a voltage in [V]
 typedef double Volts;
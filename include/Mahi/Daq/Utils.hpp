@@ -23,5 +23,8 @@ namespace daq {
 
 void print_info(const Daq& daq);
 
+/// Prints the latency histograms of a Daq and its Modules (requires MAHI_DAQ_METRICS)
+void print_latency(const Daq& daq);
+
 } // namespace daq
 } // namespace mahi
\ No newline at end of file
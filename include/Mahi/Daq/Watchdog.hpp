@@ -17,6 +17,8 @@
 #pragma once
 #include <Mahi/Daq/Module.hpp>
 #include <Mahi/Util/Timing/Time.hpp>
+#include <chrono>
+#include <cstdint>
 
 namespace mahi {
 namespace daq {
@@ -24,6 +26,9 @@ namespace daq {
 /// Encapsulates a hardware watchdog timer
 class Watchdog : public Module {
 public:
+    /// Largest fraction of timeout accepted by set_kick_fraction
+    static constexpr double MaxKickFraction = 0.9;
+
     /// Default constructor
     Watchdog(Daq& daq);
 
@@ -58,9 +63,43 @@ public:
     /// Gets the timeout period this Watchdog operatres on
     util::Time timeout() const;
 
+    /// Scheduled alternative to calling kick every control cycle. Call this every cycle
+    /// instead, passing whether the cycle completed its writes. It only kicks (one bus
+    /// transaction) once the kick fraction of timeout has elapsed since the last
+    /// successful kick, never kicks after a failed cycle, and checks is_expired once per
+    /// expiry check interval. Returns false if a kick failed or the watchdog has expired.
+    bool kick_if_due(bool cycle_ok = true);
+
+    /// Sets the fraction of timeout after a successful kick at which kick_if_due kicks
+    /// again (default 0.5). 0 kicks on every call. Because kick_if_due is only called
+    /// once per cycle, fractions above MaxKickFraction are clamped with a warning.
+    void set_kick_fraction(double fraction);
+
+    /// Sets how often kick_if_due polls is_expired. Defaults to half the timeout, so an
+    /// expired watchdog is noticed within about one timeout while costing a bus transaction
+    /// only every few cycles. Time::Zero polls on every call and Time::Inf never polls.
+    void set_expiry_check_interval(util::Time interval);
+
+    /// Returns the number of kicks made by kick_if_due
+    std::uint64_t kicks() const;
+
+    /// Returns the number of kick_if_due calls that did not need to kick
+    std::uint64_t kicks_skipped() const;
+
 protected:
     util::Time m_timout; ///< The timeout period for this Watchdog
     bool m_watching;     ///< True if watchdog has been started, false if stopped
+
+private:
+    typedef std::chrono::steady_clock Steady;
+    typedef std::chrono::duration<double, std::micro> Micros;  ///< doesn't overflow for Time::Inf
+    double             m_kick_fraction;   ///< see set_kick_fraction
+    Micros             m_check_interval;  ///< see set_expiry_check_interval (negative for half the timeout)
+    Steady::time_point m_last_kick;       ///< when kick_if_due last kicked successfully
+    Steady::time_point m_last_check;      ///< when kick_if_due last polled is_expired
+    bool               m_kicked;          ///< true once kick_if_due has kicked successfully
+    std::uint64_t      m_kicks;           ///< see kicks
+    std::uint64_t      m_kicks_skipped;   ///< see kicks_skipped
 };
 
 } // namespace daq
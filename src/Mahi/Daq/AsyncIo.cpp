@@ -0,0 +1,103 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/AsyncIo.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+const std::size_t IoWorker::Capacity;
+
+IoWorker::IoWorker(const RealtimeOptions& options) :
+    m_submitted(0),
+    m_completed(0),
+    m_discarded(0),
+    m_stop(false)
+{
+    for (auto& s : m_slots)
+        s = Slot{nullptr, nullptr, 0, false};
+    m_thread = std::thread(&IoWorker::run, this, options);
+}
+
+IoWorker::~IoWorker() {
+    cancel();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_queued.notify_one();
+    m_thread.join();
+}
+
+IoCompletion IoWorker::submit(Job job, void* target) {
+    std::uint64_t ticket;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        // back-pressure: the slot is reused only once its previous operation has finished
+        m_finished.wait(lock, [this]() { return m_submitted - m_completed.load() < Capacity; });
+        ticket = ++m_submitted;
+        m_slots[(ticket - 1) % Capacity] = Slot{job, target, ticket, false};
+    }
+    m_queued.notify_one();
+    return IoCompletion(this, ticket);
+}
+
+void IoWorker::drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this]() { return m_completed.load() == m_submitted; });
+}
+
+void IoWorker::cancel() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_discarded = m_submitted;
+    m_finished.wait(lock, [this]() { return m_completed.load() == m_submitted; });
+}
+
+bool IoWorker::wait(std::uint64_t ticket) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_finished.wait(lock, [this, ticket]() { return ready(ticket); });
+    const Slot& slot = m_slots[(ticket - 1) % Capacity];
+    if (slot.ticket != ticket) {
+        LOG(Warning) << "The result of an asynchronous I/O operation was discarded before it was waited on.";
+        return false;
+    }
+    return slot.result;
+}
+
+void IoWorker::run(RealtimeOptions options) {
+    if (!configure_realtime(options))
+        LOG(Warning) << "I/O worker is running without all requested real-time settings.";
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_queued.wait(lock, [this]() { return m_stop || m_completed.load() < m_submitted; });
+        if (m_completed.load() == m_submitted)
+            return;  // stopping, and nothing is queued
+        Slot& slot = m_slots[m_completed.load() % Capacity];
+        bool discard = slot.ticket <= m_discarded;
+        lock.unlock();
+        bool result = !discard && slot.job(slot.target);
+        lock.lock();
+        slot.result = result;
+        m_completed.fetch_add(1, std::memory_order_release);
+        m_finished.notify_all();
+    }
+}
+
+}  // namespace daq
+}  // namespace mahi
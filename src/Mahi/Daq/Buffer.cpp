@@ -14,9 +14,7 @@ BufferBase::BufferBase(ChanneledModule& module) :
     module.m_buffs.push_back(this);    
 }
 
-bool BufferBase::valid_channel(ChanNum channel_number, bool quiet) const {
-    if (m_module.m_ch_map.count(channel_number) > 0)
-        return true;
+bool BufferBase::invalid_channel(ChanNum channel_number, bool quiet) const {
     if (!quiet) {
         LOG(Error) << "Invalid channel number " << channel_number << " not declared in channel numbers on Module " << m_module.name() << ".";
     }
@@ -32,14 +30,48 @@ bool BufferBase::valid_count(std::size_t size, bool quiet) const {
     return false;
 }
 
-Readable::Readable(ChanneledModule& module) : read_with_all(false)
+CycleFlag& CycleFlag::operator=(bool value) {
+    if (value != m_value) {
+        m_value = value;
+        m_daq.invalidate_plan();
+    }
+    return *this;
+}
+
+Readable::Readable(ChanneledModule& module) : read_with_all(module.daq(), false), m_daq(module.daq())
 {
     module.daq().m_readables.push_back(this);
+    module.daq().invalidate_plan();
+}
+
+IoCompletion Readable::read_async() {
+    if (!m_daq.is_open()) {
+        LOG(Error) << "Cannot start read_async on a Buffer of " << m_daq.name() << " because it is not open";
+        return IoCompletion();
+    }
+    return m_daq.io_worker().submit([](void* r) { return static_cast<Readable*>(r)->read(); }, this);
 }
 
-Writeable::Writeable(ChanneledModule& module) : write_with_all(false)
+void Readable::abandon_io() {
+    m_daq.abandon_io();
+}
+
+Writeable::Writeable(ChanneledModule& module) : write_with_all(module.daq(), false), m_daq(module.daq())
 {
     module.daq().m_writeables.push_back(this);
+    module.daq().invalidate_plan();
+}
+
+IoCompletion Writeable::write_async() {
+    if (!m_daq.is_open()) {
+        LOG(Error) << "Cannot start write_async on a Buffer of " << m_daq.name() << " because it is not open";
+        return IoCompletion();
+    }
+    return m_daq.io_worker().submit([](void* w) { return static_cast<Writeable*>(w)->write(); }, this);
+}
+
+void Writeable::abandon_io() {
+    m_daq.abandon_io();
 }
 
 } // namespace daq
@@ -0,0 +1,199 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/ControlLoop.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+typedef std::chrono::steady_clock Steady;
+
+inline std::uint64_t ns_between(Steady::time_point a, Steady::time_point b) {
+    return b > a ? static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count()) : 0;
+}
+} // private namespace
+
+ControlLoop::ControlLoop(Daq& daq, Time period, const Options& options) :
+    daq(daq),
+    m_period(period),
+    m_options(options),
+    m_running(false),
+    m_stop(false),
+    m_cycles(0),
+    m_misses(0),
+    m_skipped(0),
+    m_failures(0),
+    m_last_us(0),
+    m_max_us(0),
+    m_max_over_us(0)
+{ }
+
+bool ControlLoop::run() {
+    bool idle = false;
+    if (!m_running.compare_exchange_strong(idle, true)) {
+        LOG(Error) << "ControlLoop for " << daq.name() << " is already running.";
+        return false;
+    }
+    if (!daq.is_enabled()) {
+        LOG(Error) << "ControlLoop for " << daq.name() << " cannot run because the DAQ is not enabled.";
+        m_running = false;
+        return false;
+    }
+    RealtimeGuard restore;  // undoes configure_realtime when run returns
+    if (!configure_realtime(m_options.realtime))
+        LOG(Warning) << "ControlLoop for " << daq.name() << " is running without all requested real-time settings.";
+    if (m_options.watchdog) {
+        // poll for expiry on cycle boundaries, about twice per timeout
+        double period_us = static_cast<double>(m_period.as_microseconds());
+        double cycles    = std::floor(0.5 * static_cast<double>(m_options.watchdog->timeout().as_microseconds()) / period_us);
+        double check_us  = std::min(std::max(cycles, 1.0) * period_us, 1e15);
+        m_options.watchdog->set_expiry_check_interval(microseconds(static_cast<std::int64_t>(check_us)));
+    }
+    const auto period = std::chrono::microseconds(m_period.as_microseconds());
+    const auto spin   = std::chrono::microseconds(m_options.spin.as_microseconds());
+    bool watchdog_ok = true;
+    auto kick = [this, &watchdog_ok](bool cycle_ok) {
+        if (!m_options.watchdog || m_options.watchdog->kick_if_due(cycle_ok))
+            return true;
+        LOG(Error) << "ControlLoop for " << daq.name() << " is stopping because its watchdog failed or expired.";
+        m_stop      = true;
+        watchdog_ok = false;
+        return false;
+    };
+    std::uint64_t overruns_logged = 0;  // reported after the loop, not from inside it
+    std::int64_t  worst_logged_us = 0;
+    const auto start  = Steady::now();
+    auto deadline     = start;  // when the current cycle should begin
+    while (!m_stop) {
+        // time the cycle
+        auto begin = Steady::now();
+        m_lateness.record(ns_between(deadline, begin));
+        Steady::time_point end;
+        bool ok = true;
+        Time t  = microseconds(std::chrono::duration_cast<std::chrono::microseconds>(begin - start).count());
+        if (m_options.fused_io) {
+            ok = daq.write_read_all();
+            ok = kick(ok) && ok;
+            auto io_end = Steady::now();
+            update(t);
+            end = Steady::now();
+            m_io.record(ns_between(begin, io_end));
+            m_compute.record(ns_between(io_end, end));
+        }
+        else {
+            ok = daq.read_all();
+            auto read_end = Steady::now();
+            update(t);
+            auto write_begin = Steady::now();
+            ok = daq.write_all() && ok;
+            ok = kick(ok) && ok;
+            end = Steady::now();
+            m_io.record(ns_between(begin, read_end) + ns_between(write_begin, end));
+            m_compute.record(ns_between(read_end, write_begin));
+        }
+        std::int64_t work_us = static_cast<std::int64_t>(ns_between(begin, end) / 1000);
+        m_last_us.store(work_us, std::memory_order_relaxed);
+        if (work_us > m_max_us.load(std::memory_order_relaxed))
+            m_max_us.store(work_us, std::memory_order_relaxed);
+        if (!ok)
+            m_failures.fetch_add(1, std::memory_order_relaxed);
+        m_cycles.fetch_add(1, std::memory_order_relaxed);
+        // schedule the next cycle
+        deadline += period;
+        auto now = Steady::now();
+        if (now > deadline) {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            std::int64_t over_us = static_cast<std::int64_t>(ns_between(deadline, now) / 1000);
+            if (over_us > m_max_over_us.load(std::memory_order_relaxed))
+                m_max_over_us.store(over_us, std::memory_order_relaxed);
+            switch (m_options.overrun) {
+                case Skip: {
+                    auto missed = (now - deadline) / period + 1;
+                    deadline += missed * period;
+                    m_skipped.fetch_add(static_cast<std::uint64_t>(missed), std::memory_order_relaxed);
+                    break;
+                }
+                case CatchUp:
+                    break;
+                case Log:
+                    overruns_logged++;
+                    worst_logged_us = std::max(worst_logged_us, over_us);
+                    deadline = now;
+                    break;
+            }
+        }
+        // hybrid wait: sleep until shortly before the deadline, then spin
+        if (deadline - now > spin)
+            std::this_thread::sleep_until(deadline - spin);
+        while (Steady::now() < deadline) {}
+        m_idle.record(ns_between(now, Steady::now()));
+    }
+    if (overruns_logged > 0)
+        LOG(Warning) << "ControlLoop for " << daq.name() << " overran its " << m_period.as_microseconds() << " us period "
+                     << overruns_logged << " times (by up to " << worst_logged_us << " us).";
+    m_stop    = false;
+    m_running = false;
+    return watchdog_ok;
+}
+
+void ControlLoop::stop() {
+    m_stop = true;
+}
+
+bool ControlLoop::is_running() const {
+    return m_running;
+}
+
+Time ControlLoop::period() const {
+    return m_period;
+}
+
+ControlLoop::Stats ControlLoop::stats() const {
+    Stats s;
+    s.cycles   = m_cycles;
+    s.misses   = m_misses;
+    s.skipped  = m_skipped;
+    s.failures    = m_failures;
+    s.last_cycle  = microseconds(m_last_us);
+    s.max_cycle   = microseconds(m_max_us);
+    s.max_overrun = microseconds(m_max_over_us);
+    return s;
+}
+
+void ControlLoop::reset_stats() {
+    m_cycles   = 0;
+    m_misses   = 0;
+    m_skipped  = 0;
+    m_failures    = 0;
+    m_last_us     = 0;
+    m_max_us      = 0;
+    m_max_over_us = 0;
+    m_io.reset();
+    m_compute.reset();
+    m_idle.reset();
+    m_lateness.reset();
+}
+
+} // namespace daq
+} // namespace mahi
@@ -7,7 +7,7 @@ using namespace mahi::util;
 namespace mahi {
 namespace daq {
 
-Daq::Daq(const std::string& name) : Device(name)
+Daq::Daq(const std::string& name) : Device(name), m_plan_dirty(true), m_pipelined(false), m_image_dirty(true)
 { }
 
 Daq::~Daq() {
@@ -17,22 +17,209 @@ Daq::~Daq() {
 
 /// Reads all readable ModuleInterfaces owned
 bool Daq::read_all() {
+    if (m_pipelined)
+        return read_pipelined();
+    LatencyTimer timer(m_read_all_latency);
+    if (m_plan_dirty)
+        compile_plan();
     bool success = true;
-    for (auto& r : m_readables) {
-        if (r->read_with_all)
-            success = r->read() ? success : false;
-    }
+    for (auto& s : m_read_plan)
+        success = s.invoke(s.target, s.chs, s.values, s.n) ? success : false;
+    if (success)
+        capture_inputs();
     return success;
 }
 
 /// Reads all writeable ModuleInterfaces owned
 bool Daq::write_all() {
+    if (m_pipelined)
+        return write_pipelined();
+    LatencyTimer timer(m_write_all_latency);
+    if (m_plan_dirty)
+        compile_plan();
     bool all_success = true;
+    for (auto& s : m_write_plan)
+        all_success = s.invoke(s.target, s.chs, s.values, s.n) ? all_success : false;
+    if (all_success)
+        capture_outputs();
+    return all_success;
+}
+
+bool Daq::write_read_all() {
+    bool written = write_all();
+    bool read    = read_all();
+    return written && read;
+}
+
+void Daq::invalidate_plan() {
+    m_plan_dirty  = true;
+    m_image_dirty = true;
+}
+
+void Daq::enable_process_image(bool enable) {
+    if (enable && !m_image)
+        m_image.reset(new ProcessImage());
+    else if (!enable)
+        m_image.reset();
+    m_image_dirty = true;
+}
+
+void Daq::capture_image(bool inputs) {
+    if (m_image_dirty) {
+        std::vector<BufferBase*> buffers;
+        for (auto& m : m_modules) {
+            if (auto cm = dynamic_cast<ChanneledModule*>(m))
+                buffers.insert(buffers.end(), cm->m_buffs.begin(), cm->m_buffs.end());
+        }
+        m_image->layout(buffers);
+        m_image_dirty = false;
+    }
+    if (inputs)
+        m_image->capture_inputs();
+    else
+        m_image->capture_outputs();
+}
+
+void Daq::reset_latency() {
+    m_read_all_latency.reset();
+    m_write_all_latency.reset();
+    for (auto& m : m_modules) {
+        if (auto cm = dynamic_cast<ChanneledModule*>(m)) {
+            cm->read_latency().reset();
+            cm->write_latency().reset();
+        }
+    }
+}
+
+void Daq::compile_plan() {
+    m_read_plan.clear();
+    m_write_plan.clear();
+    CycleStep step;
+    for (auto& r : m_readables) {
+        if (r->read_with_all && r->plan_read(step))
+            m_read_plan.push_back(step);
+    }
     for (auto& w : m_writeables) {
-        if (w->write_with_all)
-            all_success = w->write() ? all_success : false;
+        if (w->write_with_all && w->plan_write(step))
+            m_write_plan.push_back(step);
     }
-    return all_success;
+    m_pipe_reads.clear();
+    m_pipe_read_finishes.clear();
+    m_pipe_write_stages.clear();
+    m_pipe_writes.clear();
+    m_pipe_write_finishes.clear();
+    if (m_pipelined) {
+        CycleStep stage, finish;
+        for (auto& r : m_readables) {
+            if (r->read_with_all && r->plan_pipelined_read(step, finish)) {
+                m_pipe_reads.push_back(step);
+                m_pipe_read_finishes.push_back(finish);
+            }
+        }
+        for (auto& w : m_writeables) {
+            if (w->write_with_all && w->plan_pipelined_write(stage, step, finish)) {
+                m_pipe_write_stages.push_back(stage);
+                m_pipe_writes.push_back(step);
+                m_pipe_write_finishes.push_back(finish);
+            }
+        }
+    }
+    m_plan_dirty = false;
+}
+
+void Daq::set_pipelined(bool enable) {
+    if (enable == m_pipelined)
+        return;
+    drain_pipeline();
+    m_pipelined  = enable;
+    m_plan_dirty = true;
+}
+
+bool Daq::transfer_all(const std::vector<CycleStep>& steps) {
+    bool success = true;
+    for (auto& s : steps)
+        success = s.invoke(s.target, s.chs, s.values, s.n) ? success : false;
+    return success;
+}
+
+bool Daq::read_pipelined() {
+    LatencyTimer timer(m_read_all_latency);
+    // transfers may only be left in flight while open, since every Daq closes (and so drains)
+    // before its Modules are destroyed
+    if (!is_open()) {
+        LOG(Error) << "Cannot pipeline read_all on " << name() << " because it is not open";
+        return false;
+    }
+    if (m_plan_dirty) {
+        drain_pipeline();
+        compile_plan();
+    }
+    // the first cycle has nothing prefetched, so it reads now
+    if (!m_pipe_reading.valid())
+        m_pipe_reading = io_worker().submit(&Daq::transfer_reads, this);
+    bool success = m_pipe_reading.wait();
+    if (success) {
+        for (auto& s : m_pipe_read_finishes)
+            s.invoke(s.target, s.chs, s.values, s.n);
+        capture_inputs();
+    }
+    m_pipe_reading = io_worker().submit(&Daq::transfer_reads, this);
+    return success;
+}
+
+bool Daq::write_pipelined() {
+    LatencyTimer timer(m_write_all_latency);
+    // transfers may only be left in flight while open, since every Daq closes (and so drains)
+    // before its Modules are destroyed
+    if (!is_open()) {
+        LOG(Error) << "Cannot pipeline write_all on " << name() << " because it is not open";
+        return false;
+    }
+    if (m_plan_dirty) {
+        drain_pipeline();
+        compile_plan();
+    }
+    bool success = finish_pipelined_write();
+    for (auto& s : m_pipe_write_stages)
+        s.invoke(s.target, s.chs, s.values, s.n);
+    capture_outputs();
+    m_pipe_writing = io_worker().submit(&Daq::transfer_writes, this);
+    return success;
+}
+
+bool Daq::finish_pipelined_write() {
+    if (!m_pipe_writing.valid())
+        return true;
+    bool success = m_pipe_writing.wait();
+    if (success) {
+        for (auto& s : m_pipe_write_finishes)
+            s.invoke(s.target, s.chs, s.values, s.n);
+    }
+    m_pipe_writing = IoCompletion();
+    return success;
+}
+
+void Daq::drain_pipeline() {
+    finish_pipelined_write();
+    m_pipe_reading.wait();
+    m_pipe_reading = IoCompletion();
+}
+
+void Daq::abandon_io() {
+    if (m_io)
+        m_io->cancel();
+    m_pipe_writing = IoCompletion();
+    m_pipe_reading = IoCompletion();
+}
+
+bool Daq::transfer_reads(void* daq) {
+    Daq* self = static_cast<Daq*>(daq);
+    return self->transfer_all(self->m_pipe_reads);
+}
+
+bool Daq::transfer_writes(void* daq) {
+    Daq* self = static_cast<Daq*>(daq);
+    return self->transfer_all(self->m_pipe_writes);
 }
 
 bool Daq::on_open() {
@@ -48,6 +235,9 @@ bool Daq::on_open() {
 bool Daq::on_close() {
     if (is_enabled())
         disable();
+    drain_pipeline();
+    if (m_io)
+        m_io->drain();
     bool all_success = true;
     for (auto& m : m_modules) 
         all_success = m->on_daq_close() ? all_success : false;
@@ -73,12 +263,50 @@ bool Daq::on_disable() {
         LOG(Error) << "Cannot disable " << name() << " because it is not open";
         return false;
     }
+    drain_pipeline();
+    if (m_io)
+        m_io->drain();
     bool all_success = true;
     for (auto& m : m_modules) 
         all_success = m->on_daq_disable() ? all_success : false;
     return on_daq_disable() && all_success;
 }
 
+void Daq::enable_async_io(const RealtimeOptions& options) {
+    if (!m_io)
+        m_io.reset(new IoWorker(options));
+}
+
+IoCompletion Daq::read_all_async() {
+    if (!is_open()) {
+        LOG(Error) << "Cannot start read_all_async on " << name() << " because it is not open";
+        return IoCompletion();
+    }
+    if (m_pipelined) {
+        LOG(Error) << "Cannot start read_all_async on " << name() << " because it is pipelined";
+        return IoCompletion();
+    }
+    return io_worker().submit([](void* daq) { return static_cast<Daq*>(daq)->read_all(); }, this);
+}
+
+IoCompletion Daq::write_all_async() {
+    if (!is_open()) {
+        LOG(Error) << "Cannot start write_all_async on " << name() << " because it is not open";
+        return IoCompletion();
+    }
+    if (m_pipelined) {
+        LOG(Error) << "Cannot start write_all_async on " << name() << " because it is pipelined";
+        return IoCompletion();
+    }
+    return io_worker().submit([](void* daq) { return static_cast<Daq*>(daq)->write_all(); }, this);
+}
+
+IoWorker& Daq::io_worker() {
+    if (!m_io)
+        enable_async_io();
+    return *m_io;
+}
+
 const std::vector<Module*>& Daq::modules() const {
     return m_modules;
 }
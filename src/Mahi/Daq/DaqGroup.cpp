@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/DaqGroup.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+const int s_spins = 2000;  // yields a worker spins for before sleeping
+} // private namespace
+
+DaqGroup::DaqGroup(const std::vector<Daq*>& daqs, const std::vector<RealtimeOptions>& options) :
+    m_daqs(daqs), m_cycle(0), m_op(ReadAll), m_running(true), m_sleepers(0)
+{
+    for (std::size_t i = 0; i < m_daqs.size(); ++i) {
+        m_workers.emplace_back(new Worker());
+        m_workers[i]->options = i < options.size() ? options[i] : RealtimeOptions();
+        m_workers[i]->done     = 0;
+        m_workers[i]->result   = true;
+        m_workers[i]->failures = 0;
+    }
+    for (std::size_t i = 1; i < m_daqs.size(); ++i)
+        m_workers[i]->thread = std::thread(&DaqGroup::run, this, i);
+}
+
+DaqGroup::~DaqGroup() {
+    m_running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_wake.notify_all();
+    for (auto& w : m_workers) {
+        if (w->thread.joinable())
+            w->thread.join();
+    }
+}
+
+bool DaqGroup::read_all() {
+    return cycle(ReadAll);
+}
+
+bool DaqGroup::write_all() {
+    return cycle(WriteAll);
+}
+
+bool DaqGroup::write_read_all() {
+    return cycle(WriteReadAll);
+}
+
+const std::vector<Daq*>& DaqGroup::daqs() const {
+    return m_daqs;
+}
+
+bool DaqGroup::succeeded(std::size_t i) const {
+    return m_workers[i]->result;
+}
+
+std::uint64_t DaqGroup::failures(std::size_t i) const {
+    return m_workers[i]->failures;
+}
+
+bool DaqGroup::execute(std::size_t i, Op op) {
+    bool result = false;
+    switch (op) {
+        case ReadAll:      result = m_daqs[i]->read_all(); break;
+        case WriteAll:     result = m_daqs[i]->write_all(); break;
+        case WriteReadAll: result = m_daqs[i]->write_read_all(); break;
+    }
+    m_workers[i]->result = result;
+    if (!result)
+        m_workers[i]->failures.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+bool DaqGroup::cycle(Op op) {
+    if (m_daqs.empty())
+        return true;
+    m_op.store(op, std::memory_order_relaxed);
+    std::uint64_t c = m_cycle.fetch_add(1) + 1;
+    // if any worker went to sleep, wake it (m_sleepers and m_cycle are sequentially consistent,
+    // so a worker either sees the new cycle or is counted here)
+    if (m_sleepers.load() > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_wake.notify_all();
+    }
+    bool success = execute(0, op);
+    // barrier: wait for every worker to finish this cycle
+    for (std::size_t i = 1; i < m_workers.size(); ++i) {
+        while (m_workers[i]->done.load(std::memory_order_acquire) != c)
+            std::this_thread::yield();
+        success = m_workers[i]->result && success;
+    }
+    return success;
+}
+
+void DaqGroup::run(std::size_t i) {
+    if (!configure_realtime(m_workers[i]->options))
+        LOG(Warning) << "DaqGroup worker for " << m_daqs[i]->name() << " is running without all requested real-time settings.";
+    std::uint64_t seen = 0;
+    while (true) {
+        // spin for the next cycle, then sleep
+        int spins = 0;
+        while (m_cycle.load() == seen && m_running.load() && spins++ < s_spins)
+            std::this_thread::yield();
+        if (m_cycle.load() == seen && m_running.load()) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleepers++;
+            m_wake.wait(lock, [&]() { return m_cycle.load() != seen || !m_running.load(); });
+            m_sleepers--;
+        }
+        if (!m_running.load())
+            return;
+        seen = m_cycle.load();
+        execute(i, static_cast<Op>(m_op.load(std::memory_order_relaxed)));
+        m_workers[i]->done.store(seen, std::memory_order_release);
+    }
+}
+
+} // namespace daq
+} // namespace mahi
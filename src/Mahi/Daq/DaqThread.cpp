@@ -0,0 +1,85 @@
+#include <Mahi/Daq/DaqThread.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+DaqThread::Loop::Loop(DaqThread& owner, Daq& daq, Time period, const RealtimeOptions& options) :
+    ControlLoop(daq, period, ControlLoop::Options(ControlLoop::Skip, options)),
+    m_owner(owner)
+{ }
+
+void DaqThread::Loop::update(Time t) {
+    m_owner.cycle(t);
+}
+
+void DaqThread::cycle(Time t) {
+    if (update)
+        update(t);
+}
+
+DaqThread::DaqThread(Daq& daq, Time period, const RealtimeOptions& options) :
+    m_daq(daq),
+    m_loop(*this, daq, period, options),
+    m_running(false)
+{ }
+
+DaqThread::~DaqThread() {
+    stop();
+}
+
+bool DaqThread::start() {
+    if (m_running || m_thread.joinable()) {
+        LOG(Warning) << "Acquisition thread for " << m_daq.name() << " is already running.";
+        return false;
+    }
+    if (!m_daq.is_enabled()) {
+        LOG(Error) << "Acquisition thread for " << m_daq.name() << " cannot start because the DAQ is not enabled.";
+        return false;
+    }
+    m_running = true;
+    m_thread = std::thread(&DaqThread::run, this);
+    return true;
+}
+
+void DaqThread::stop() {
+    // only a started thread may be stopped, so no request is left for the next start
+    if (!m_thread.joinable())
+        return;
+    m_loop.stop();
+    m_thread.join();
+}
+
+bool DaqThread::is_running() const {
+    return m_running;
+}
+
+Time DaqThread::period() const {
+    return m_loop.period();
+}
+
+DaqThread::Stats DaqThread::stats() const {
+    ControlLoop::Stats loop = m_loop.stats();
+    Stats s;
+    s.cycles      = loop.cycles;
+    s.overruns    = loop.misses;
+    s.io_failures = loop.failures;
+    s.last_cycle  = loop.last_cycle;
+    s.max_cycle   = loop.max_cycle;
+    s.max_overrun = loop.max_overrun;
+    return s;
+}
+
+void DaqThread::reset_stats() {
+    m_loop.reset_stats();
+}
+
+void DaqThread::run() {
+    m_loop.run();
+    m_running = false;
+}
+
+} // namespace daq
+} // namespace mahi
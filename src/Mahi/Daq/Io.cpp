@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Io.hpp>
+#include <cstring>
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+/// Returns the index of the lowest set bit of x, which must not be 0
+inline unsigned lowest_bit(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned i = 0;
+    while (!((x >> i) & 1))
+        ++i;
+    return i;
+#endif
+}
+
+/// Packs n (up to 64) TTL levels into the low bits of a word, 8 at a time: masking each
+/// byte to 0/1 and multiplying gathers the 8 low bits into the top byte
+inline std::uint64_t pack(const TTL* levels, std::size_t n) {
+    std::uint64_t bits = 0;
+    for (std::size_t k = 0; k < n; k += 8) {
+        std::uint64_t x = 0;
+        std::memcpy(&x, levels + k, n - k < 8 ? n - k : 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        x = __builtin_bswap64(x);
+#endif
+        x &= 0x0101010101010101ULL;
+        bits |= ((x * 0x0102040810204080ULL) >> 56) << k;
+    }
+    return bits;
+}
+
+} // private namespace
+
+DIModule::DIModule(Daq& daq, const ChanNums& allowed) :
+    InputModule<TTL>(daq, allowed),
+    on_edge(nullptr),
+    m_edges(false),
+    m_connected(false),
+    m_primed(false),
+    m_debounce(0)
+{ }
+
+void DIModule::enable_edges(bool enable, unsigned int debounce) {
+    m_edges    = enable;
+    m_debounce = debounce;
+    m_primed   = false;
+    if (enable && !m_connected) {
+        connect_post_read(*this, [this](const ChanNum*, const TTL*, std::size_t) {
+            if (m_edges)
+                detect_edges();
+        });
+        m_connected = true;
+    }
+}
+
+void DIModule::remap(const ChanMap& old_map, const ChanMap& new_map) {
+    InputModule<TTL>::remap(old_map, new_map);
+    m_primed = false;
+}
+
+void DIModule::detect_edges() {
+    const std::vector<TTL>& levels = buffer();
+    const std::size_t n     = levels.size();
+    const std::size_t words = (n + 63) / 64;
+    // capture the initial state (only allocates after enable_edges or set_channels)
+    const bool prime = !m_primed || m_raw.size() != words;
+    if (prime)
+        m_raw.assign(words, 0);
+    for (std::size_t w = 0; w < words; ++w)
+        m_raw[w] = pack(&levels[w * 64], n - w * 64 < 64 ? n - w * 64 : 64);
+    if (prime) {
+        m_state   = m_raw;
+        m_rising.assign(words, 0);
+        m_falling.assign(words, 0);
+        m_pending.assign(words, 0);
+        m_counts.assign(n, 0);
+        m_primed = true;
+        return;
+    }
+    for (std::size_t w = 0; w < words; ++w) {
+        const std::uint64_t diff = m_raw[w] ^ m_state[w];
+        std::uint64_t accept     = diff;
+        if (m_debounce > 1) {
+            // channels that bounced back to their state restart their count
+            for (std::uint64_t reset = m_pending[w] & ~diff; reset; reset &= reset - 1)
+                m_counts[w * 64 + lowest_bit(reset)] = 0;
+            accept = 0;
+            for (std::uint64_t d = diff; d; d &= d - 1) {
+                unsigned b = lowest_bit(d);
+                if (++m_counts[w * 64 + b] >= m_debounce) {
+                    accept |= std::uint64_t(1) << b;
+                    m_counts[w * 64 + b] = 0;
+                }
+            }
+            m_pending[w] = diff & ~accept;
+        }
+        m_rising[w]  = accept & m_raw[w];
+        m_falling[w] = accept & ~m_raw[w];
+        m_state[w] ^= accept;
+    }
+    // dispatch only the channels that changed
+    const ChanNums& chs = channels();
+    for (std::size_t w = 0; w < words; ++w) {
+        for (std::uint64_t e = m_rising[w] | m_falling[w]; e; e &= e - 1) {
+            unsigned b = lowest_bit(e);
+            on_edge.emit(chs[w * 64 + b], ((m_rising[w] >> b) & 1) != 0);
+        }
+    }
+}
+
+} // namespace daq
+} // namespace mahi
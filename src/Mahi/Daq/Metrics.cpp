@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Metrics.hpp>
+#include <cmath>
+
+#ifdef MAHI_DAQ_METRICS
+
+namespace mahi {
+namespace daq {
+
+std::uint64_t LatencyHistogram::percentile(double p) const {
+    std::uint64_t total = count();
+    if (total == 0)
+        return 0;
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total)));
+    if (rank == 0)
+        rank = 1;
+    std::uint64_t max  = m_max.load(std::memory_order_relaxed);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < NumBuckets; ++i) {
+        seen += m_buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            std::uint64_t edge = bucket_max(i);
+            return edge < max ? edge : max;
+        }
+    }
+    return max;
+}
+
+LatencyStats LatencyHistogram::stats() const {
+    LatencyStats s;
+    s.count   = count();
+    s.p50_ns  = percentile(0.5);
+    s.p99_ns  = percentile(0.99);
+    s.p999_ns = percentile(0.999);
+    s.max_ns  = m_max.load(std::memory_order_relaxed);
+    return s;
+}
+
+void LatencyHistogram::reset() {
+    for (std::size_t i = 0; i < NumBuckets; ++i)
+        m_buckets[i].store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LatencyHistogram::bucket_max(std::size_t i) {
+    if (i < 8)
+        return i;
+    if (i == NumBuckets - 1)
+        return static_cast<std::uint64_t>(-1);
+    std::size_t   e   = i / 8 + 2;
+    std::uint64_t sub = i % 8;
+    return ((8 + sub + 1) << (e - 3)) - 1;
+}
+
+}  // namespace daq
+}  // namespace mahi
+
+#endif
@@ -28,17 +28,11 @@ inline bool contains(const ChanNums& chs, ChanNum ch) {
     return std::count(chs.begin(), chs.end(), ch) > 0;
 }
 
-inline ChanMap make_channel_map(const ChanNums& channel_numbers) {
-    ChanMap channel_map;
-    for (std::size_t i = 0; i < channel_numbers.size(); ++i)
-        channel_map[channel_numbers[i]] = i;
-    return channel_map;
-}
-
 } // namespace private
 
 Module::Module(Daq& daq) : m_daq(daq), m_name("UNAMED_MODULE") {
     m_daq.m_modules.push_back(this);
+    m_daq.invalidate_plan();
 }
 
 const std::string& Module::name() const {
@@ -55,7 +49,9 @@ Daq& Module::daq() const {
 
 ChanneledModule::ChanneledModule(Daq& daq, const ChanNums& allowed) : 
     Module(daq),
-    m_chs_allowed(allowed)
+    m_chs_allowed(allowed),
+    m_snapshot_cycle(0),
+    m_generation(1)
 { }
 
 bool ChanneledModule::set_channels(const ChanNums& chs) {
@@ -82,6 +78,8 @@ bool ChanneledModule::set_channels(const ChanNums& chs) {
         if (!proceed)
             return false;
     }
+    if (!on_set_channels(requested))
+        return false;
     // save the previous channels
     auto previous = m_chs_public;
     // determine channels gained
@@ -97,6 +95,8 @@ bool ChanneledModule::set_channels(const ChanNums& chs) {
             freed.push_back(prev);
     }
 
+    // a pipelined transfer may be using the channels and buffers about to change
+    daq().drain_pipeline();
     // set the new channels
     m_chs_public = requested;
     // update internal representation
@@ -105,9 +105,13 @@ bool ChanneledModule::set_channels(const ChanNums& chs) {
         m_chs_internal[i] = convert_channel(m_chs_public[i]);
     // remap channels
     ChanMap old_map = m_ch_map;
-    m_ch_map = make_channel_map(m_chs_public);
+    m_ch_map = ChanMap(m_chs_public);
     for (std::size_t i = 0; i < m_buffs.size(); i++)
         m_buffs[i]->remap(old_map, m_ch_map); 
+    // buffer and channel pointers have moved, so the DAQ must recompile its cycle plan
+    // and Handles must re-resolve their buffer indices
+    daq().invalidate_plan();
+    m_generation++;
     // relinquish shared pins
     if (shares_pins()) {
         for (auto relation : share_list_map()[this]) {
@@ -169,6 +173,21 @@ ChanNum ChanneledModule::convert_channel(ChanNum public_facing) const {
     return public_facing;
 }
 
+void ChanneledModule::enable_snapshots(bool enable) {
+    m_snapshots.clear();
+    for (auto& b : m_buffs) {
+        b->enable_snapshot(enable);
+        if (enable)
+            m_snapshots.push_back(b);
+    }
+}
+
+void ChanneledModule::publish_snapshots_impl() {
+    m_snapshot_cycle++;
+    for (auto& b : m_snapshots)
+        b->publish_snapshot(m_snapshot_cycle);
+}
+
 bool ChanneledModule::shares_pins() const {
     for (auto& entry : share_list_map()) {
         if (entry.first == this)
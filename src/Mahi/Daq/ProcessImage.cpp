@@ -0,0 +1,110 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/ProcessImage.hpp>
+#include <Mahi/Daq/Buffer.hpp>
+#include <cstring>
+
+namespace mahi {
+namespace daq {
+
+constexpr std::size_t ProcessImage::Alignment;
+constexpr std::size_t ProcessImage::npos;
+
+namespace {
+inline std::size_t align_up(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+} // private namespace
+
+ProcessImage::ProcessImage() :
+    m_data(nullptr),
+    m_size(0),
+    m_outputs_offset(0),
+    m_layouts(0)
+{ }
+
+std::size_t ProcessImage::offset(const BufferBase& buffer) const {
+    for (auto& s : m_inputs) {
+        if (s.buffer == &buffer)
+            return s.offset;
+    }
+    for (auto& s : m_outputs) {
+        if (s.buffer == &buffer)
+            return s.offset;
+    }
+    return npos;
+}
+
+void ProcessImage::copy(void* dst) const {
+    if (m_size > 0)
+        std::memcpy(dst, m_data, m_size);
+}
+
+void ProcessImage::layout(const std::vector<BufferBase*>& buffers) {
+    // outputs are Writeables that are not also Readable; everything else is read or
+    // computed from reads, so it belongs with the inputs
+    std::vector<BufferBase*> ins, outs;
+    for (auto& b : buffers) {
+        if (dynamic_cast<Writeable*>(b) && !dynamic_cast<Readable*>(b))
+            outs.push_back(b);
+        else
+            ins.push_back(b);
+    }
+    m_inputs.clear();
+    m_outputs.clear();
+    std::size_t cursor = place(ins, m_inputs, 0);
+    m_outputs_offset   = align_up(cursor, Alignment);
+    cursor             = place(outs, m_outputs, m_outputs_offset);
+    m_size             = align_up(cursor, Alignment);
+    // zeroed so that padding and not yet captured sections are deterministic
+    m_storage.assign(m_size + Alignment, 0);
+    auto addr = reinterpret_cast<std::uintptr_t>(m_storage.data());
+    m_data    = m_storage.data() + (align_up(addr, Alignment) - addr);
+    m_layouts++;
+}
+
+void ProcessImage::capture_inputs() {
+    capture(m_inputs);
+}
+
+void ProcessImage::capture_outputs() {
+    capture(m_outputs);
+}
+
+std::size_t ProcessImage::place(const std::vector<BufferBase*>& buffers, std::vector<Section>& sections, std::size_t cursor) {
+    for (auto& b : buffers) {
+        if (b->raw_size() == 0)
+            continue;
+        Section s;
+        s.buffer = b;
+        s.source = b->raw_data();
+        s.offset = align_up(cursor, b->raw_align());
+        s.bytes  = b->raw_size();
+        sections.push_back(s);
+        cursor = s.offset + s.bytes;
+    }
+    return cursor;
+}
+
+void ProcessImage::capture(const std::vector<Section>& sections) {
+    // Buffer value types are plain data (numbers, TTL, Range, Time, enums)
+    for (auto& s : sections)
+        std::memcpy(m_data + s.offset, s.source, s.bytes);
+}
+
+} // namespace daq
+} // namespace mahi
@@ -14,27 +14,18 @@ QuanserAI::QuanserAI(QuanserDaq& d,QuanserHandle& h, const ChanNums& allowed) :
     ranges(*this, {-10,10}), m_h(h)
 {
     set_name(d.name() + ".AI");
-    
-    auto on_read_impl = [this](const ChanNum* chs, Volts* vals, std::size_t n) {
-        t_error result = hil_read_analog(m_h, chs, static_cast<t_uint32>(n), vals);
-        if (result == 0)
-            return true;
-        else {
-            LOG(Error) << "Failed to read " << name() << " analog inputs " << quanser_msg(result);
-            return false;
-        }
-        return true;
-    };
-    connect_read(*this, on_read_impl);
+    // Read Channels
+    bind_read<QuanserAI, Volts, &QuanserAI::read_impl>(*this);
     // Write Ranges
-    auto ranges_write_impl = [this](const ChanNum* chs, const Range<Volts>* vals, std::size_t n) { 
-        std::vector<Volts> temp_mins(n);
-        std::vector<Volts> temp_maxs(n);
+    Scratch<Volts> scratch_mins(allowed.size()), scratch_maxs(allowed.size());
+    auto ranges_write_impl = [this, scratch_mins, scratch_maxs](const ChanNum* chs, const Range<Volts>* vals, std::size_t n) mutable { 
+        Volts* temp_mins = scratch_mins.get(n);
+        Volts* temp_maxs = scratch_maxs.get(n);
         for (int i = 0; i < n; ++i) {
             temp_mins[i] = vals[i].min_val;
             temp_maxs[i] = vals[i].max_val;
         }
-        t_error result = hil_set_analog_input_ranges(m_h, chs, static_cast<t_uint32>(n), &temp_mins[0], &temp_maxs[0]);
+        t_error result = hil_set_analog_input_ranges(m_h, chs, static_cast<t_uint32>(n), temp_mins, temp_maxs);
         if (result == 0) {
             LOG(Verbose) << "Wrote " << name() << " analog input ranges.";
             return true;
@@ -48,5 +39,13 @@ QuanserAI::QuanserAI(QuanserDaq& d,QuanserHandle& h, const ChanNums& allowed) :
     connect_write(ranges, ranges_write_impl);
 }
 
+bool QuanserAI::read_impl(const ChanNum* chs, Volts* vals, std::size_t n) {
+    t_error result = hil_read_analog(m_h, chs, static_cast<t_uint32>(n), vals);
+    if (result == 0)
+        return true;
+    LOG(Error) << "Failed to read " << name() << " analog inputs " << quanser_msg(result);
+    return false;
+}
+
 } // namespace daq 
 } // namespace mahi
\ No newline at end of file
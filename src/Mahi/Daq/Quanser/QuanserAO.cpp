@@ -15,15 +15,7 @@ QuanserAO::QuanserAO(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed)
 {
     set_name(d.name() + ".AO");
     /// Write Channels
-    auto write_impl = [this](const ChanNum *chs, const Volts *vals, std::size_t n) {
-        t_error result = hil_write_analog(m_h, chs, static_cast<t_uint32>(n), vals);
-        if (result != 0) {
-            LOG(Error) << "Failed to write " << this->name() << " analog outputs " << quanser_msg(result);
-            return false;
-        }
-        return true;
-    };
-    connect_write(*this, write_impl);
+    bind_write<QuanserAO, Volts, &QuanserAO::write_impl>(*this);
     // Write Expire States
     auto expire_write_impl = [this](const ChanNum* chs, const Volts* vals, std::size_t n) { 
         t_error result = hil_watchdog_set_analog_expiration_state(m_h, chs, static_cast<t_uint32>(n), vals);
@@ -38,14 +30,15 @@ QuanserAO::QuanserAO(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed)
     };
     connect_write(expire_values, expire_write_impl);
     // Write Ranges
-    auto ranges_write_impl = [this](const ChanNum* chs, const Range<Volts>* vals, std::size_t n) { 
-        std::vector<Volts> temp_mins(n);
-        std::vector<Volts> temp_maxs(n);
+    Scratch<Volts> scratch_mins(allowed.size()), scratch_maxs(allowed.size());
+    auto ranges_write_impl = [this, scratch_mins, scratch_maxs](const ChanNum* chs, const Range<Volts>* vals, std::size_t n) mutable { 
+        Volts* temp_mins = scratch_mins.get(n);
+        Volts* temp_maxs = scratch_maxs.get(n);
         for (int i = 0; i < n; ++i) {
             temp_mins[i] = vals[i].min_val;
             temp_maxs[i] = vals[i].max_val;
         }
-        t_error result = hil_set_analog_output_ranges(m_h, chs, static_cast<t_uint32>(n), &temp_mins[0], &temp_maxs[0]);
+        t_error result = hil_set_analog_output_ranges(m_h, chs, static_cast<t_uint32>(n), temp_mins, temp_maxs);
         if (result == 0) {
             LOG(Verbose) << "Wrote " << name() << " analog output ranges.";
             return true;
@@ -58,6 +51,15 @@ QuanserAO::QuanserAO(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed)
     connect_write(ranges, ranges_write_impl);
 }
 
+bool QuanserAO::write_impl(const ChanNum* chs, const Volts* vals, std::size_t n) {
+    t_error result = hil_write_analog(m_h, chs, static_cast<t_uint32>(n), vals);
+    if (result != 0) {
+        LOG(Error) << "Failed to write " << this->name() << " analog outputs " << quanser_msg(result);
+        return false;
+    }
+    return true;
+}
+
 bool QuanserAO::init_channels(const ChanNums& chs) {
     return expire_values.write(chs, std::vector<Volts>(chs.size(), 0)) &&  ranges.write(chs, std::vector<Range<Volts>>(chs.size(), {-10,10}));
 }
@@ -15,17 +15,15 @@ QuanserDI::QuanserDI(QuanserDaq& d,QuanserHandle& h, bool bidirectional, const C
 {
     // Quanser uses char type as their buffer
     set_name(d.name() + ".DI");
-    auto on_read_impl = [this](const ChanNum* chs, TTL* vals, std::size_t n) {
-        t_error result = hil_read_digital(m_h, chs, static_cast<t_uint32>(n), vals);
-        if (result == 0)
-            return true;
-        else {
-            LOG(Error) << "Failed to read " << name() << " digital inputs " << quanser_msg(result);
-            return false;
-        }
+    bind_read<QuanserDI, TTL, &QuanserDI::read_impl>(*this);
+}
+
+bool QuanserDI::read_impl(const ChanNum* chs, TTL* vals, std::size_t n) {
+    t_error result = hil_read_digital(m_h, chs, static_cast<t_uint32>(n), vals);
+    if (result == 0)
         return true;
-    };
-    connect_read(*this, on_read_impl);
+    LOG(Error) << "Failed to read " << name() << " digital inputs " << quanser_msg(result);
+    return false;
 }
 
 bool QuanserDI::init_channels(const ChanNums& chs) {
@@ -15,27 +15,20 @@ QuanserDO::QuanserDO(QuanserDaq& d, QuanserHandle& h, bool bidirectional, const
 {
     set_name(d.name() + ".DO");
     /// Write Channels
-    auto write_impl = [this](const ChanNum *chs, const TTL *vals, std::size_t n) {
-        t_error result = hil_write_digital(m_h, chs, static_cast<t_uint32>(n), vals);
-        if (result != 0) {
-            LOG(Error) << "Failed to write " << this->name() << " digital outputs " << quanser_msg(result);
-            return false;
-        }
-        return true;
-    };
-    connect_write(*this, write_impl);
+    bind_write<QuanserDO, TTL, &QuanserDO::write_impl>(*this);
     // // Write Expire States
-    auto expire_write_impl = [this](const ChanNum* chs, const TTL* vals, std::size_t n) { 
+    Scratch<t_digital_state> scratch(allowed.size());
+    auto expire_write_impl = [this, scratch](const ChanNum* chs, const TTL* vals, std::size_t n) mutable { 
         // convert to Quanser t_digital_state
-        std::vector<t_digital_state> converted(n);
-        for (int i = 0; i < n; ++i) {
+        t_digital_state* converted = scratch.get(n);
+        for (std::size_t i = 0; i < n; ++i) {
             if (vals[i] == TTL_HIGH)
-                converted.push_back(DIGITAL_STATE_HIGH);
+                converted[i] = DIGITAL_STATE_HIGH;
             else
-                converted.push_back(DIGITAL_STATE_LOW);
+                converted[i] = DIGITAL_STATE_LOW;
         }
         t_error result;
-        result = hil_watchdog_set_digital_expiration_state(m_h, chs, static_cast<ChanNum>(n), &converted[0]);
+        result = hil_watchdog_set_digital_expiration_state(m_h, chs, static_cast<ChanNum>(n), converted);
         if (result == 0) {
             LOG(Verbose) << "Wrote " << name() << " digital output expiration sates.";
             return true;
@@ -48,6 +41,15 @@ QuanserDO::QuanserDO(QuanserDaq& d, QuanserHandle& h, bool bidirectional, const
     connect_write(expire_values, expire_write_impl);
 }
 
+bool QuanserDO::write_impl(const ChanNum* chs, const TTL* vals, std::size_t n) {
+    t_error result = hil_write_digital(m_h, chs, static_cast<t_uint32>(n), vals);
+    if (result != 0) {
+        LOG(Error) << "Failed to write " << this->name() << " digital outputs " << quanser_msg(result);
+        return false;
+    }
+    return true;
+}
+
 bool QuanserDO::init_channels(const ChanNums& chs) {
     if (chs.size() == 0)
         return true;
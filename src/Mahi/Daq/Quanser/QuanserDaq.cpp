@@ -74,6 +74,7 @@ bool QuanserDaq::read_all() {
         const bool read_EN = (m_rw->EN != nullptr && m_rw->EN->channels_internal().size() > 0 && m_rw->EN->read_with_all );
         const bool read_DI = (m_rw->DI != nullptr && m_rw->DI->channels_internal().size() > 0 && m_rw->DI->read_with_all );;
         const bool read_OI = (m_rw->OI != nullptr && m_rw->OI->channels_internal().size() > 0 && m_rw->OI->read_with_all );
+        LatencyTimer timer(read_all_latency());
         auto result = hil_read(m_h, 
             read_AI ? &m_rw->AI->channels_internal()[0] : nullptr,                     // analog channels
             read_AI ? static_cast<t_uint32>(m_rw->AI->channels_internal().size()) : 0, // num analog channels 
@@ -88,12 +89,24 @@ bool QuanserDaq::read_all() {
             read_DI ? &m_rw->DI->buffer()[0] : nullptr,                                // digital buffer
             read_OI ? &m_rw->OI->buffer()[0] : nullptr                                 // other buffer
         );
+        // the single synced read is attributed to every Module that took part
+        const std::uint64_t ns = timer.elapsed_ns();
+        if (read_AI) { m_rw->AI->read_latency().record(ns); }
+        if (read_EN) { m_rw->EN->read_latency().record(ns); }
+        if (read_DI) { m_rw->DI->read_latency().record(ns); }
+        if (read_OI) { m_rw->OI->read_latency().record(ns); }
         if (result == 0) {
             // call post read callbacks
             if (read_AI) { m_rw->AI->post_read.emit(&m_rw->AI->channels_internal()[0], &m_rw->AI->buffer()[0], m_rw->AI->channels_internal().size()); }
             if (read_EN) { m_rw->EN->post_read.emit(&m_rw->EN->channels_internal()[0], &m_rw->EN->buffer()[0], m_rw->EN->channels_internal().size()); }
             if (read_DI) { m_rw->DI->post_read.emit(&m_rw->DI->channels_internal()[0], &m_rw->DI->buffer()[0], m_rw->DI->channels_internal().size()); }
             if (read_OI) { m_rw->OI->post_read.emit(&m_rw->OI->channels_internal()[0], &m_rw->OI->buffer()[0], m_rw->OI->channels_internal().size()); }
+            // publish snapshots for non-RT consumers
+            if (read_AI) { m_rw->AI->publish_snapshots(); }
+            if (read_EN) { m_rw->EN->publish_snapshots(); }
+            if (read_DI) { m_rw->DI->publish_snapshots(); }
+            if (read_OI) { m_rw->OI->publish_snapshots(); }
+            capture_inputs();
             return true;
         }
         LOG(Error) << "Failed to read all inputs on " << name() << " " << quanser_msg(result);
@@ -109,6 +122,7 @@ bool QuanserDaq::write_all() {
         const bool read_PW = (m_rw->PW != nullptr && m_rw->PW->channels_internal().size() > 0 && m_rw->PW->write_with_all );
         const bool read_DO = (m_rw->DO != nullptr && m_rw->DO->channels_internal().size() > 0 && m_rw->DO->write_with_all );;
         const bool read_OO = (m_rw->OO != nullptr && m_rw->OO->channels_internal().size() > 0 && m_rw->OO->write_with_all );
+        LatencyTimer timer(write_all_latency());
         auto result = hil_write(m_h, 
             read_AO ? &m_rw->AO->channels_internal()[0] : nullptr,                     // analog channels
             read_AO ? static_cast<t_uint32>(m_rw->AO->channels_internal().size()) : 0, // num analog channels 
@@ -123,12 +137,19 @@ bool QuanserDaq::write_all() {
             read_DO ? &m_rw->DO->buffer()[0] : nullptr,                                // digital buffer
             read_OO ? &m_rw->OO->buffer()[0] : nullptr                                 // other buffer
         );
+        // the single synced write is attributed to every Module that took part
+        const std::uint64_t ns = timer.elapsed_ns();
+        if (read_AO) { m_rw->AO->write_latency().record(ns); }
+        if (read_PW) { m_rw->PW->write_latency().record(ns); }
+        if (read_DO) { m_rw->DO->write_latency().record(ns); }
+        if (read_OO) { m_rw->OO->write_latency().record(ns); }
         if (result == 0) {
             // call post read callbacks
             if (read_AO) { m_rw->AO->post_write.emit(&m_rw->AO->channels_internal()[0], &m_rw->AO->buffer()[0], m_rw->AO->channels_internal().size()); }
             if (read_PW) { m_rw->PW->post_write.emit(&m_rw->PW->channels_internal()[0], &m_rw->PW->buffer()[0], m_rw->PW->channels_internal().size()); }
             if (read_DO) { m_rw->DO->post_write.emit(&m_rw->DO->channels_internal()[0], &m_rw->DO->buffer()[0], m_rw->DO->channels_internal().size()); }
             if (read_OO) { m_rw->OO->post_write.emit(&m_rw->OO->channels_internal()[0], &m_rw->OO->buffer()[0], m_rw->OO->channels_internal().size()); }
+            capture_outputs();
             return true;
         }
         LOG(Error) << "Failed to write all outputs on " << name() << " " << quanser_msg(result);
@@ -137,6 +158,80 @@ bool QuanserDaq::write_all() {
     return Daq::write_all();
 }
 
+bool QuanserDaq::write_read_all() {
+    if (!m_rw->synced_read || !m_rw->synced_write)
+        return Daq::write_read_all();
+    // check: 1) not nullptr, 2) has more than 0 channels, and 3) client wants it to be read/written with all
+    const bool read_AI  = (m_rw->AI != nullptr && m_rw->AI->channels_internal().size() > 0 && m_rw->AI->read_with_all );
+    const bool read_EN  = (m_rw->EN != nullptr && m_rw->EN->channels_internal().size() > 0 && m_rw->EN->read_with_all );
+    const bool read_DI  = (m_rw->DI != nullptr && m_rw->DI->channels_internal().size() > 0 && m_rw->DI->read_with_all );
+    const bool read_OI  = (m_rw->OI != nullptr && m_rw->OI->channels_internal().size() > 0 && m_rw->OI->read_with_all );
+    const bool write_AO = (m_rw->AO != nullptr && m_rw->AO->channels_internal().size() > 0 && m_rw->AO->write_with_all );
+    const bool write_PW = (m_rw->PW != nullptr && m_rw->PW->channels_internal().size() > 0 && m_rw->PW->write_with_all );
+    const bool write_DO = (m_rw->DO != nullptr && m_rw->DO->channels_internal().size() > 0 && m_rw->DO->write_with_all );
+    const bool write_OO = (m_rw->OO != nullptr && m_rw->OO->channels_internal().size() > 0 && m_rw->OO->write_with_all );
+    // the one transaction is both this cycle's write_all and read_all
+    LatencyTimer timer(read_all_latency());
+    auto result = hil_write_read(m_h,
+        read_AI  ? &m_rw->AI->channels_internal()[0] : nullptr,                     // analog input channels
+        read_AI  ? static_cast<t_uint32>(m_rw->AI->channels_internal().size()) : 0, // num analog input channels
+        read_EN  ? &m_rw->EN->channels_internal()[0] : nullptr,                     // encoder channels
+        read_EN  ? static_cast<t_uint32>(m_rw->EN->channels_internal().size()) : 0, // num encoder channels
+        read_DI  ? &m_rw->DI->channels_internal()[0] : nullptr,                     // digital input channels
+        read_DI  ? static_cast<t_uint32>(m_rw->DI->channels_internal().size()) : 0, // num digital input channels
+        read_OI  ? &m_rw->OI->channels_internal()[0] : nullptr,                     // other input channels
+        read_OI  ? static_cast<t_uint32>(m_rw->OI->channels_internal().size()) : 0, // num other input channels
+        write_AO ? &m_rw->AO->channels_internal()[0] : nullptr,                     // analog output channels
+        write_AO ? static_cast<t_uint32>(m_rw->AO->channels_internal().size()) : 0, // num analog output channels
+        write_PW ? &m_rw->PW->channels_internal()[0] : nullptr,                     // pwm channels
+        write_PW ? static_cast<t_uint32>(m_rw->PW->channels_internal().size()) : 0, // num pwm channels
+        write_DO ? &m_rw->DO->channels_internal()[0] : nullptr,                     // digital output channels
+        write_DO ? static_cast<t_uint32>(m_rw->DO->channels_internal().size()) : 0, // num digital output channels
+        write_OO ? &m_rw->OO->channels_internal()[0] : nullptr,                     // other output channels
+        write_OO ? static_cast<t_uint32>(m_rw->OO->channels_internal().size()) : 0, // num other output channels
+        read_AI  ? &m_rw->AI->buffer()[0] : nullptr,                                // analog input buffer
+        read_EN  ? &m_rw->EN->buffer()[0] : nullptr,                                // encoder buffer
+        read_DI  ? &m_rw->DI->buffer()[0] : nullptr,                                // digital input buffer
+        read_OI  ? &m_rw->OI->buffer()[0] : nullptr,                                // other input buffer
+        write_AO ? &m_rw->AO->buffer()[0] : nullptr,                                // analog output buffer
+        write_PW ? &m_rw->PW->buffer()[0] : nullptr,                                // pwm buffer
+        write_DO ? &m_rw->DO->buffer()[0] : nullptr,                                // digital output buffer
+        write_OO ? &m_rw->OO->buffer()[0] : nullptr                                 // other output buffer
+    );
+    const std::uint64_t ns = timer.elapsed_ns();
+    write_all_latency().record(ns);
+    if (read_AI)  { m_rw->AI->read_latency().record(ns); }
+    if (read_EN)  { m_rw->EN->read_latency().record(ns); }
+    if (read_DI)  { m_rw->DI->read_latency().record(ns); }
+    if (read_OI)  { m_rw->OI->read_latency().record(ns); }
+    if (write_AO) { m_rw->AO->write_latency().record(ns); }
+    if (write_PW) { m_rw->PW->write_latency().record(ns); }
+    if (write_DO) { m_rw->DO->write_latency().record(ns); }
+    if (write_OO) { m_rw->OO->write_latency().record(ns); }
+    if (result == 0) {
+        // call post write callbacks
+        if (write_AO) { m_rw->AO->post_write.emit(&m_rw->AO->channels_internal()[0], &m_rw->AO->buffer()[0], m_rw->AO->channels_internal().size()); }
+        if (write_PW) { m_rw->PW->post_write.emit(&m_rw->PW->channels_internal()[0], &m_rw->PW->buffer()[0], m_rw->PW->channels_internal().size()); }
+        if (write_DO) { m_rw->DO->post_write.emit(&m_rw->DO->channels_internal()[0], &m_rw->DO->buffer()[0], m_rw->DO->channels_internal().size()); }
+        if (write_OO) { m_rw->OO->post_write.emit(&m_rw->OO->channels_internal()[0], &m_rw->OO->buffer()[0], m_rw->OO->channels_internal().size()); }
+        // call post read callbacks
+        if (read_AI) { m_rw->AI->post_read.emit(&m_rw->AI->channels_internal()[0], &m_rw->AI->buffer()[0], m_rw->AI->channels_internal().size()); }
+        if (read_EN) { m_rw->EN->post_read.emit(&m_rw->EN->channels_internal()[0], &m_rw->EN->buffer()[0], m_rw->EN->channels_internal().size()); }
+        if (read_DI) { m_rw->DI->post_read.emit(&m_rw->DI->channels_internal()[0], &m_rw->DI->buffer()[0], m_rw->DI->channels_internal().size()); }
+        if (read_OI) { m_rw->OI->post_read.emit(&m_rw->OI->channels_internal()[0], &m_rw->OI->buffer()[0], m_rw->OI->channels_internal().size()); }
+        // publish snapshots for non-RT consumers
+        if (read_AI) { m_rw->AI->publish_snapshots(); }
+        if (read_EN) { m_rw->EN->publish_snapshots(); }
+        if (read_DI) { m_rw->DI->publish_snapshots(); }
+        if (read_OI) { m_rw->OI->publish_snapshots(); }
+        capture_outputs();
+        capture_inputs();
+        return true;
+    }
+    LOG(Error) << "Failed to write all outputs and read all inputs on " << name() << " " << quanser_msg(result);
+    return false;
+}
+
 bool QuanserDaq::set_options(const QuanserOptions& options) {
     if (valid()) {
         char options_str[4096];
@@ -17,16 +17,7 @@ QuanserEncoder::QuanserEncoder(QuanserDaq& d, QuanserHandle& h, const ChanNums&
 {
     set_name(d.name() + ".encoder");
     // Read Encoders
-    auto read_impl = [this](const ChanNum* chs, int* counts, std::size_t n) {
-        t_error result = hil_read_encoder(m_h, chs, static_cast<t_uint32>(n), counts);
-        if (result == 0)
-            return true;
-        else {
-            LOG(Error) << "Failed to read " << name() << " " << quanser_msg(result);
-            return false;
-        }
-    };
-    connect_read(*this, read_impl);
+    bind_read<QuanserEncoder, Counts, &QuanserEncoder::read_impl>(*this);
     // Write Encoders
     auto write_impl = [this](const ChanNum* chs, const int* counts, std::size_t n) {
         t_error result = hil_set_encoder_counts(m_h, chs, static_cast<t_uint32>(n), counts);
@@ -42,8 +33,9 @@ QuanserEncoder::QuanserEncoder(QuanserDaq& d, QuanserHandle& h, const ChanNums&
     };
     connect_write(*this, write_impl);
     /// Write Quadratue Factors
-    auto write_quad_impl = [this](const ChanNum* chs, const QuadMode* quads, std::size_t n) {
-        std::vector<t_encoder_quadrature_mode> converted_factors(n);
+    Scratch<t_encoder_quadrature_mode> scratch(allowed.size());
+    auto write_quad_impl = [this, scratch](const ChanNum* chs, const QuadMode* quads, std::size_t n) mutable {
+        t_encoder_quadrature_mode* converted_factors = scratch.get(n);
         for (int i = 0; i < n; ++i) {
             if (quads[i] == QuadMode::X0)
                 converted_factors[i] = ENCODER_QUADRATURE_NONE;
@@ -58,7 +50,7 @@ QuanserEncoder::QuanserEncoder(QuanserDaq& d, QuanserHandle& h, const ChanNums&
                 return false;
             }
         }
-        t_error result = hil_set_encoder_quadrature_mode(m_h, chs, static_cast<t_uint32>(n), &converted_factors[0]);
+        t_error result = hil_set_encoder_quadrature_mode(m_h, chs, static_cast<t_uint32>(n), converted_factors);
         util::sleep(milliseconds(10));
         if (result == 0) {
             LOG(Verbose) << "Wrote " << name() << " quadrature factors.";
@@ -72,6 +64,14 @@ QuanserEncoder::QuanserEncoder(QuanserDaq& d, QuanserHandle& h, const ChanNums&
     connect_write(modes, write_quad_impl);
 }
 
+bool QuanserEncoder::read_impl(const ChanNum* chs, Counts* counts, std::size_t n) {
+    t_error result = hil_read_encoder(m_h, chs, static_cast<t_uint32>(n), counts);
+    if (result == 0)
+        return true;
+    LOG(Error) << "Failed to read " << name() << " " << quanser_msg(result);
+    return false;
+}
+
 bool QuanserEncoder::init_channels(const ChanNums& chs) {
     return modes.write(chs, std::vector<QuadMode>(chs.size(), QuadMode::X4));
 }
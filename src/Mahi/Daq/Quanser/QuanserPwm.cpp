@@ -24,16 +24,7 @@ QuanserPwm::QuanserPwm(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed,
     m_h(h) {
     set_name(d.name() + ".PWM");
     // Write Channels
-    auto write_impl = [this](const ChanNum* chs, const double* vals, std::size_t n) {
-        t_error result = hil_write_pwm(m_h, chs, static_cast<t_uint32>(n), vals);
-        if (result != 0) {
-            LOG(Error) << "Failed to write " << this->name() << " PWM outputs. "
-                       << quanser_msg(result);
-            return false;
-        }
-        return true;
-    };
-    connect_write(*this, write_impl);
+    bind_write<QuanserPwm, double, &QuanserPwm::write_impl>(*this);
     // Write Expire States
     auto expire_write_impl = [this](const ChanNum* chs, const double* vals, std::size_t n) {
         t_error result =
@@ -48,8 +39,9 @@ QuanserPwm::QuanserPwm(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed,
     };
     connect_write(expire_values, expire_write_impl);
     // Write modes
-    auto mode_write_impl = [this](const ChanNum* chs, const Mode* vals, std::size_t n) {
-        std::vector<t_pwm_mode> qmodes(n);
+    Scratch<t_pwm_mode> scratch(allowed.size());
+    auto mode_write_impl = [this, scratch](const ChanNum* chs, const Mode* vals, std::size_t n) mutable {
+        t_pwm_mode* qmodes = scratch.get(n);
         for (int i = 0; i < n; ++i) {
             if (vals[i] == Mode::DutyCycle)
                 qmodes[i] = PWM_DUTY_CYCLE_MODE;
@@ -60,7 +52,7 @@ QuanserPwm::QuanserPwm(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed,
             else if (vals[i] == Mode::OneShot)
                 qmodes[i] = PWM_ONE_SHOT_MODE;
         }
-        t_error result = hil_set_pwm_mode(m_h, chs, static_cast<t_uint32>(n), &qmodes[0]);
+        t_error result = hil_set_pwm_mode(m_h, chs, static_cast<t_uint32>(n), qmodes);
         if (result == 0) {
             LOG(Verbose) << "Wrote " << name() << " PWM modes.";
             return true;
@@ -93,6 +85,15 @@ QuanserPwm::QuanserPwm(QuanserDaq& d, QuanserHandle& h, const ChanNums& allowed,
     connect_write(duty_cycles, duty_write_impl);
 }
 
+bool QuanserPwm::write_impl(const ChanNum* chs, const double* vals, std::size_t n) {
+    t_error result = hil_write_pwm(m_h, chs, static_cast<t_uint32>(n), vals);
+    if (result != 0) {
+        LOG(Error) << "Failed to write " << this->name() << " PWM outputs. " << quanser_msg(result);
+        return false;
+    }
+    return true;
+}
+
 bool QuanserPwm::init_channels(const ChanNums& chs) {
     bool success = true;
     if (m_on_gain_custom) {
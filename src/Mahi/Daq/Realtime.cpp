@@ -0,0 +1,114 @@
+#include <Mahi/Daq/Realtime.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+// touches bytes of stack one page-sized frame at a time
+void touch_stack(std::size_t bytes) {
+    volatile unsigned char page[4096];
+    for (std::size_t i = 0; i < sizeof(page); i += 64)
+        page[i] = 0;
+    if (bytes > sizeof(page))
+        touch_stack(bytes - sizeof(page));
+    page[0] = page[0];  // keeps this frame alive across the recursion
+}
+} // private namespace
+
+void prefault_stack(std::size_t bytes) {
+    if (bytes > 0)
+        touch_stack(bytes);
+}
+
+#if defined(__linux__)
+
+bool configure_realtime(const RealtimeOptions& options) {
+    bool success = true;
+    prefault_stack(options.prefault_stack);
+    if (options.lock_memory) {
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            LOG(Error) << "Failed to lock memory with mlockall (" << std::strerror(errno) << ").";
+            success = false;
+        }
+    }
+    if (options.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(options.cpu, &set);
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result != 0) {
+            LOG(Error) << "Failed to pin thread to CPU " << options.cpu << " (" << std::strerror(result) << ").";
+            success = false;
+        }
+    }
+    if (options.priority > 0) {
+        sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = options.priority;
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0) {
+            LOG(Error) << "Failed to set SCHED_FIFO priority " << options.priority << " (" << std::strerror(result) << ").";
+            success = false;
+        }
+    }
+    return success;
+}
+
+struct RealtimeGuard::State {
+    bool        has_affinity;  ///< true if affinity was saved
+    cpu_set_t   affinity;      ///< the saved affinity
+    bool        has_sched;     ///< true if the scheduler was saved
+    int         policy;        ///< the saved scheduling policy
+    sched_param param;         ///< the saved scheduling parameters
+};
+
+RealtimeGuard::RealtimeGuard() : m_state(new State()) {
+    m_state->has_affinity = pthread_getaffinity_np(pthread_self(), sizeof(m_state->affinity), &m_state->affinity) == 0;
+    m_state->has_sched    = pthread_getschedparam(pthread_self(), &m_state->policy, &m_state->param) == 0;
+}
+
+RealtimeGuard::~RealtimeGuard() {
+    if (m_state->has_sched) {
+        int result = pthread_setschedparam(pthread_self(), m_state->policy, &m_state->param);
+        if (result != 0)
+            LOG(Error) << "Failed to restore the thread scheduler (" << std::strerror(result) << ").";
+    }
+    if (m_state->has_affinity) {
+        int result = pthread_setaffinity_np(pthread_self(), sizeof(m_state->affinity), &m_state->affinity);
+        if (result != 0)
+            LOG(Error) << "Failed to restore the thread CPU affinity (" << std::strerror(result) << ").";
+    }
+}
+
+#else
+
+struct RealtimeGuard::State { };
+
+RealtimeGuard::RealtimeGuard() { }
+
+RealtimeGuard::~RealtimeGuard() { }
+
+bool configure_realtime(const RealtimeOptions& options) {
+    prefault_stack(options.prefault_stack);
+    if (options.lock_memory || options.cpu >= 0 || options.priority > 0) {
+        LOG(Error) << "Real-time thread configuration is only supported on Linux.";
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,227 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Recorder.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+const char s_magic[8] = {'M', 'A', 'H', 'I', 'R', 'E', 'C', '1'};
+} // private namespace
+
+Recorder::Recorder(std::size_t capacity) :
+    m_capacity(capacity > 0 ? capacity : 1),
+    m_stride(1),
+    m_file(nullptr),
+    m_running(false),
+    m_recorded(0),
+    m_dropped(0),
+    m_written(0),
+    m_head(0),
+    m_tail(0)
+{ }
+
+Recorder::~Recorder() {
+    close();
+}
+
+bool Recorder::add_column(const void* buffer, double (*get)(const void*, ChanNum),
+                          const ChanneledModule& module, ChanNum ch, const std::string& name) {
+    if (is_open()) {
+        LOG(Error) << "Cannot add columns to Recorder while recording.";
+        return false;
+    }
+    if (std::find(module.channels().begin(), module.channels().end(), ch) == module.channels().end()) {
+        LOG(Error) << "Cannot record invalid channel number " << ch << " of " << module.name() << ".";
+        return false;
+    }
+    m_columns.push_back({buffer, get, ch});
+    m_names.push_back(name.empty() ? module.name() + "[" + std::to_string(ch) + "]" : name);
+    return true;
+}
+
+bool Recorder::open(const std::string& filename) {
+    if (is_open()) {
+        LOG(Error) << "Recorder is already recording.";
+        return false;
+    }
+    if (m_columns.empty()) {
+        LOG(Error) << "Recorder has no columns to record.";
+        return false;
+    }
+    m_file = std::fopen(filename.c_str(), "wb");
+    if (!m_file) {
+        LOG(Error) << "Failed to open recording " << filename << ".";
+        return false;
+    }
+    std::uint32_t count = static_cast<std::uint32_t>(m_names.size());
+    std::fwrite(s_magic, 1, sizeof(s_magic), m_file);
+    std::fwrite(&count, sizeof(count), 1, m_file);
+    for (auto& n : m_names) {
+        std::uint32_t length = static_cast<std::uint32_t>(n.size());
+        std::fwrite(&length, sizeof(length), 1, m_file);
+        std::fwrite(n.data(), 1, n.size(), m_file);
+    }
+    m_stride = 1 + m_columns.size();
+    m_ring.assign((m_capacity + 1) * m_stride, 0);
+    m_head     = 0;
+    m_tail     = 0;
+    m_recorded = 0;
+    m_dropped  = 0;
+    m_written  = 0;
+    m_running  = true;
+    m_thread   = std::thread(&Recorder::run, this);
+    return true;
+}
+
+void Recorder::close() {
+    if (!is_open())
+        return;
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+    drain();
+    std::fclose(m_file);
+    m_file = nullptr;
+}
+
+bool Recorder::is_open() const {
+    return m_file != nullptr;
+}
+
+bool Recorder::record(Time t) {
+    if (!m_running.load(std::memory_order_relaxed)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    std::size_t next = tail + 1 == m_capacity + 1 ? 0 : tail + 1;
+    if (next == m_head.load(std::memory_order_acquire)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    double* row = &m_ring[tail * m_stride];
+    row[0] = t.as_seconds();
+    for (std::size_t i = 0; i < m_columns.size(); ++i)
+        row[i + 1] = m_columns[i].get(m_columns[i].buffer, m_columns[i].ch);
+    m_tail.store(next, std::memory_order_release);
+    m_recorded.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::uint64_t Recorder::recorded() const {
+    return m_recorded;
+}
+
+std::uint64_t Recorder::dropped() const {
+    return m_dropped;
+}
+
+std::uint64_t Recorder::written() const {
+    return m_written;
+}
+
+const std::vector<std::string>& Recorder::columns() const {
+    return m_names;
+}
+
+void Recorder::run() {
+    while (m_running) {
+        if (!drain()) {
+            LOG(Error) << "Failed to write recording; further rows will be dropped.";
+            m_running = false;
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+bool Recorder::drain() {
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    std::size_t tail = m_tail.load(std::memory_order_acquire);
+    while (head != tail) {
+        // write the contiguous run up to the tail or the end of the ring
+        std::size_t end  = tail > head ? tail : m_capacity + 1;
+        std::size_t rows = end - head;
+        if (std::fwrite(&m_ring[head * m_stride], sizeof(double) * m_stride, rows, m_file) != rows)
+            return false;
+        m_written.fetch_add(rows, std::memory_order_relaxed);
+        head = end == m_capacity + 1 ? 0 : end;
+        m_head.store(head, std::memory_order_release);
+    }
+    return true;
+}
+
+bool Recorder::to_csv(const std::string& recording, const std::string& csv) {
+    std::FILE* in = std::fopen(recording.c_str(), "rb");
+    if (!in) {
+        LOG(Error) << "Failed to open recording " << recording << ".";
+        return false;
+    }
+    char          magic[8];
+    std::uint32_t count = 0;
+    if (std::fread(magic, 1, sizeof(magic), in) != sizeof(magic) ||
+        std::memcmp(magic, s_magic, sizeof(magic)) != 0 ||
+        std::fread(&count, sizeof(count), 1, in) != 1) {
+        LOG(Error) << recording << " is not a mahi::daq recording.";
+        std::fclose(in);
+        return false;
+    }
+    std::vector<std::string> names(count);
+    for (auto& n : names) {
+        std::uint32_t length = 0;
+        if (std::fread(&length, sizeof(length), 1, in) != 1) {
+            std::fclose(in);
+            return false;
+        }
+        n.resize(length);
+        if (length > 0 && std::fread(&n[0], 1, length, in) != length) {
+            std::fclose(in);
+            return false;
+        }
+    }
+    std::ofstream out(csv);
+    if (!out) {
+        LOG(Error) << "Failed to open " << csv << ".";
+        std::fclose(in);
+        return false;
+    }
+    out << "Time";
+    for (auto& n : names)
+        out << "," << n;
+    out << "\n";
+    out.precision(17);
+    std::vector<double> row(1 + count);
+    while (std::fread(row.data(), sizeof(double), row.size(), in) == row.size()) {
+        out << row[0];
+        for (std::size_t i = 1; i < row.size(); ++i)
+            out << "," << row[i];
+        out << "\n";
+    }
+    std::fclose(in);
+    return static_cast<bool>(out);
+}
+
+} // namespace daq
+} // namespace mahi
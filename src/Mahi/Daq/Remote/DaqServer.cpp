@@ -0,0 +1,271 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Remote/DaqServer.hpp>
+#include <Mahi/Daq/Buffer.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+/// How long a client must be silent before another may take over the server in [ns]
+const std::int64_t ClientTimeoutNs = 1000000000;
+
+/// Returns the steady clock in [ns]
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Returns a TraceStream describing the values of buffer, bytes in total
+TraceStream describe_buffer(BufferBase& buffer, bool output, TraceType type, std::size_t bytes) {
+    TraceStream s;
+    s.module   = buffer.module().name();
+    s.output   = output;
+    s.type     = type;
+    s.channels = buffer.module().channels();
+    s.internal = buffer.module().channels_internal();
+    s.size     = s.channels.empty() ? 0 : bytes / s.channels.size();
+    return s;
+}
+
+} // private namespace
+
+DaqServer::DaqServer(Daq& daq) :
+    m_daq(daq),
+    m_in_bytes(0),
+    m_tx_size(0),
+    m_last_seq(0),
+    m_answered(false),
+    m_client(false),
+    m_heard_ns(0),
+    m_running(false),
+    m_cycles(0)
+{ }
+
+DaqServer::~DaqServer() {
+    close();
+}
+
+bool DaqServer::open(unsigned short port, const std::string& address) {
+    if (is_open())
+        return true;
+    describe();
+    std::size_t out_bytes = 0;
+    for (auto& s : m_outputs)
+        out_bytes += 1 + s.buffer->raw_size();
+    std::vector<char> schema;
+    encode_schema(m_schema, schema);
+    std::size_t largest = std::max(std::max(schema.size(), m_in_bytes), out_bytes);
+    if (sizeof(RemoteHeader) + largest > RemoteMaxDatagram) {
+        LOG(Error) << "Cannot serve " << m_daq.name() << " because its channels do not fit in one datagram.";
+        return false;
+    }
+    if (!m_socket.bind(address, port))
+        return false;
+    m_rx.assign(RemoteMaxDatagram, 0);
+    m_tx.assign(RemoteMaxDatagram, 0);
+    m_answered = false;
+    m_client   = false;
+    LOG(Verbose) << "Serving " << m_daq.name() << " on " << address << ":" << m_socket.port() << " with "
+                 << m_inputs.size() << " inputs and " << m_outputs.size() << " outputs.";
+    return true;
+}
+
+void DaqServer::close() {
+    stop();
+    m_socket.close();
+}
+
+bool DaqServer::is_open() const {
+    return m_socket.is_open();
+}
+
+unsigned short DaqServer::port() const {
+    return m_socket.port();
+}
+
+bool DaqServer::poll(Time timeout) {
+    long got = m_socket.receive(&m_rx[0], m_rx.size(), timeout);
+    if (got <= 0)
+        return false;
+    handle(static_cast<std::size_t>(got));
+    return true;
+}
+
+bool DaqServer::start(const RealtimeOptions& options) {
+    if (!is_open() || m_running)
+        return false;
+    m_running = true;
+    m_thread  = std::thread([this, options]() {
+        if (!configure_realtime(options))
+            LOG(Warning) << "Server thread for " << m_daq.name() << " is running without all requested real-time settings.";
+        while (m_running)
+            poll(milliseconds(10));
+    });
+    return true;
+}
+
+void DaqServer::stop() {
+    m_running = false;
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool DaqServer::is_running() const {
+    return m_running;
+}
+
+std::uint64_t DaqServer::cycles() const {
+    return m_cycles;
+}
+
+const std::vector<TraceStream>& DaqServer::streams() const {
+    return m_schema;
+}
+
+void DaqServer::describe() {
+    m_schema.clear();
+    m_inputs.clear();
+    m_outputs.clear();
+    m_in_bytes = 0;
+    for (auto& r : m_daq.m_readables) {
+        BufferBase* b = dynamic_cast<BufferBase*>(r);
+        if (!b || !r->read_with_all || b->raw_type() == TraceType::Opaque || b->module().channels().empty())
+            continue;
+        Stream s = {b, r, nullptr};
+        m_inputs.push_back(s);
+        m_schema.push_back(describe_buffer(*b, false, b->raw_type(), b->raw_size()));
+        m_in_bytes += b->raw_size();
+    }
+    for (auto& w : m_daq.m_writeables) {
+        BufferBase* b = dynamic_cast<BufferBase*>(w);
+        if (!b || b->raw_type() == TraceType::Opaque || b->module().channels().empty())
+            continue;
+        Stream s = {b, nullptr, w};
+        m_outputs.push_back(s);
+        m_schema.push_back(describe_buffer(*b, true, b->raw_type(), b->raw_size()));
+    }
+}
+
+void DaqServer::handle(std::size_t size) {
+    RemoteHeader request;
+    if (size < sizeof(RemoteHeader))
+        return;
+    std::memcpy(&request, &m_rx[0], sizeof(RemoteHeader));
+    if (request.magic != RemoteMagic || request.size != size - sizeof(RemoteHeader))
+        return;
+    if (request.type == RemoteMessage::Describe) {
+        if (!m_socket.from_peer()) {
+            if (m_client && now_ns() - m_heard_ns < ClientTimeoutNs) {
+                LOG(Warning) << "Refused " << m_socket.sender() << " because " << m_daq.name() << " is serving another client.";
+                return;
+            }
+            m_socket.set_peer();
+            m_client = true;
+        }
+        m_heard_ns = now_ns();
+        std::vector<char> schema;
+        encode_schema(m_schema, schema);
+        std::memcpy(&m_tx[sizeof(RemoteHeader)], schema.data(), schema.size());
+        reply(request, RemoteMessage::Schema, 0, schema.size(), 0);
+        m_answered = false;  // a (re)connecting client starts a new sequence
+    }
+    else if (request.type == RemoteMessage::Cycle) {
+        // only the client that described the Daq may drive it
+        if (!m_socket.from_peer())
+            return;
+        m_heard_ns = now_ns();
+        // a retransmission of the last request (its reply was lost): answer it again
+        if (m_answered && request.seq == m_last_seq) {
+            m_socket.send(&m_tx[0], m_tx_size);
+            return;
+        }
+        std::int64_t start = now_ns();
+        bool ok = cycle(request, &m_rx[sizeof(RemoteHeader)]);
+        std::size_t bytes = 0;
+        if (request.flags & RemoteRead) {
+            for (auto& s : m_inputs) {
+                std::memcpy(&m_tx[sizeof(RemoteHeader) + bytes], s.buffer->raw_data(), s.buffer->raw_size());
+                bytes += s.buffer->raw_size();
+            }
+        }
+        m_last_seq = request.seq;
+        m_answered = true;
+        ++m_cycles;
+        reply(request, RemoteMessage::State, request.flags | (ok ? 0 : RemoteFailed), bytes, now_ns() - start);
+    }
+}
+
+bool DaqServer::cycle(const RemoteHeader& request, const char* payload) {
+    bool write = (request.flags & RemoteWrite) != 0;
+    bool read  = (request.flags & RemoteRead) != 0;
+    // unpack outputs, noting whether they are exactly what write_all writes
+    bool        as_all = true;
+    const char* p      = payload;
+    const char* end    = payload + request.size;
+    for (std::size_t i = 0; write && i < m_outputs.size(); ++i) {
+        BufferBase* b = m_outputs[i].buffer;
+        if (p == end)
+            return false;
+        bool present = *p++ != 0;
+        if (present) {
+            if (static_cast<std::size_t>(end - p) < b->raw_size())
+                return false;
+            std::memcpy(b->raw_data(), p, b->raw_size());
+            p += b->raw_size();
+        }
+        as_all = as_all && present == static_cast<bool>(m_outputs[i].writable->write_with_all);
+    }
+    if (write && read && as_all)
+        return m_daq.write_read_all();
+    bool ok = true;
+    if (write && as_all)
+        ok = m_daq.write_all();
+    else if (write) {
+        // a partial write, e.g. a client's immediate AO.write: write only what was sent
+        p = payload;
+        for (std::size_t i = 0; i < m_outputs.size(); ++i) {
+            if (*p++ != 0) {
+                ok = m_outputs[i].writable->write() && ok;
+                p += m_outputs[i].buffer->raw_size();
+            }
+        }
+    }
+    if (read)
+        ok = m_daq.read_all() && ok;
+    return ok;
+}
+
+void DaqServer::reply(const RemoteHeader& request, RemoteMessage type, std::uint8_t flags, std::size_t size, std::int64_t server_ns) {
+    RemoteHeader header = request;
+    header.type      = type;
+    header.flags     = flags;
+    header.size      = static_cast<std::uint32_t>(size);
+    header.server_ns = server_ns;
+    std::memcpy(&m_tx[0], &header, sizeof(RemoteHeader));
+    m_tx_size = sizeof(RemoteHeader) + size;
+    m_socket.send(&m_tx[0], m_tx_size);
+}
+
+} // namespace daq
+} // namespace mahi
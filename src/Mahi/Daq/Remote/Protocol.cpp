@@ -0,0 +1,280 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Remote/Protocol.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAHI_DAQ_POSIX_SOCKETS
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+template <typename T>
+void put(std::vector<char>& out, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+bool get(const char*& p, const char* end, T& value) {
+    if (static_cast<std::size_t>(end - p) < sizeof(T))
+        return false;
+    std::memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+}
+
+} // private namespace
+
+//==============================================================================
+// SCHEMA
+//==============================================================================
+
+void encode_schema(const std::vector<TraceStream>& streams, std::vector<char>& out) {
+    put(out, static_cast<std::uint32_t>(streams.size()));
+    for (auto& s : streams) {
+        put(out, static_cast<std::uint32_t>(s.module.size()));
+        out.insert(out.end(), s.module.begin(), s.module.end());
+        put(out, static_cast<std::uint8_t>(s.output));
+        put(out, static_cast<std::uint8_t>(s.type));
+        put(out, static_cast<std::uint16_t>(s.size));
+        put(out, static_cast<std::uint32_t>(s.channels.size()));
+        for (auto& ch : s.channels)
+            put(out, static_cast<std::uint32_t>(ch));
+    }
+}
+
+bool decode_schema(const char* data, std::size_t size, std::vector<TraceStream>& streams) {
+    const char* p   = data;
+    const char* end = data + size;
+    std::uint32_t count;
+    streams.clear();
+    if (!get(p, end, count))
+        return false;
+    for (std::uint32_t i = 0; i < count; ++i) {
+        TraceStream   s;
+        std::uint32_t len, chs;
+        std::uint8_t  output, type;
+        std::uint16_t bytes;
+        if (!get(p, end, len) || static_cast<std::size_t>(end - p) < len)
+            return false;
+        s.module.assign(p, len);
+        p += len;
+        if (!get(p, end, output) || !get(p, end, type) || !get(p, end, bytes) || !get(p, end, chs) ||
+            static_cast<std::size_t>(end - p) < chs * sizeof(std::uint32_t))
+            return false;
+        s.output = output != 0;
+        s.type   = static_cast<TraceType>(type);
+        s.size   = bytes;
+        s.channels.resize(chs);
+        for (auto& ch : s.channels) {
+            std::uint32_t c;
+            if (!get(p, end, c))
+                return false;
+            ch = c;
+        }
+        s.internal = s.channels;
+        streams.push_back(s);
+    }
+    return p == end;
+}
+
+//==============================================================================
+// UDP SOCKET
+//==============================================================================
+
+UdpSocket::UdpSocket() : m_fd(-1), m_connected(false), m_peer_size(0), m_kept_size(0) { }
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::is_open() const {
+    return m_fd != -1;
+}
+
+#ifdef MAHI_DAQ_POSIX_SOCKETS
+
+bool UdpSocket::bind(const std::string& address, unsigned short port) {
+    close();
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1) {
+        LOG(Error) << "Cannot bind UDP port " << port << " to " << address << " because it is not an IPv4 address.";
+        return false;
+    }
+    m_fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_fd == -1) {
+        LOG(Error) << "Failed to create UDP socket (" << std::strerror(errno) << ").";
+        return false;
+    }
+    if (::bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1) {
+        LOG(Error) << "Failed to bind UDP port " << port << " on " << address << " (" << std::strerror(errno) << ").";
+        close();
+        return false;
+    }
+    m_connected = false;
+    return true;
+}
+
+bool UdpSocket::connect(const std::string& host, unsigned short port) {
+    close();
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found   = nullptr;
+    if (::getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &found) != 0 || !found) {
+        LOG(Error) << "Failed to resolve " << host << ".";
+        return false;
+    }
+    m_fd = ::socket(found->ai_family, found->ai_socktype, found->ai_protocol);
+    bool ok = m_fd != -1 && ::connect(m_fd, found->ai_addr, found->ai_addrlen) == 0;
+    ::freeaddrinfo(found);
+    if (!ok) {
+        LOG(Error) << "Failed to open UDP socket to " << host << ":" << port << " (" << std::strerror(errno) << ").";
+        close();
+        return false;
+    }
+    m_connected = true;
+    return true;
+}
+
+void UdpSocket::close() {
+    if (m_fd != -1)
+        ::close(m_fd);
+    m_fd        = -1;
+    m_peer_size = 0;
+    m_kept_size = 0;
+}
+
+unsigned short UdpSocket::port() const {
+    sockaddr_in addr;
+    socklen_t   size = sizeof(addr);
+    if (m_fd == -1 || ::getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &size) == -1)
+        return 0;
+    return ntohs(addr.sin_port);
+}
+
+bool UdpSocket::send(const void* data, std::size_t size) {
+    if (m_fd == -1)
+        return false;
+    ssize_t sent = m_connected ? ::send(m_fd, data, size, 0)
+                               : m_peer_size ? ::sendto(m_fd, data, size, 0, reinterpret_cast<sockaddr*>(m_peer), m_peer_size) : -1;
+    return sent == static_cast<ssize_t>(size);
+}
+
+long UdpSocket::receive(void* data, std::size_t capacity, Time timeout) {
+    if (m_fd == -1)
+        return -1;
+    pollfd pfd;
+    pfd.fd      = m_fd;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    long long us = timeout.as_microseconds();
+    int ms = us <= 0 ? 0 : us >= 2147483647000LL ? -1 : static_cast<int>((us + 999) / 1000);  // -1 waits forever
+    int ready = ::poll(&pfd, 1, ms);
+    if (ready == 0)
+        return 0;
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+    socklen_t peer_size = sizeof(m_peer);
+    ssize_t got = ::recvfrom(m_fd, data, capacity, 0, reinterpret_cast<sockaddr*>(m_peer), &peer_size);
+    if (got < 0)
+        return errno == ECONNREFUSED || errno == EINTR ? 0 : -1;
+    m_peer_size = static_cast<unsigned int>(peer_size);
+    return static_cast<long>(got);
+}
+
+void UdpSocket::set_peer() {
+    std::memcpy(m_kept, m_peer, m_peer_size);
+    m_kept_size = m_peer_size;
+}
+
+bool UdpSocket::from_peer() const {
+    if (m_kept_size == 0 || m_kept_size != m_peer_size || m_kept_size < sizeof(sockaddr_in))
+        return false;
+    const sockaddr_in* kept = reinterpret_cast<const sockaddr_in*>(m_kept);
+    const sockaddr_in* last = reinterpret_cast<const sockaddr_in*>(m_peer);
+    return kept->sin_family == last->sin_family && kept->sin_port == last->sin_port &&
+           kept->sin_addr.s_addr == last->sin_addr.s_addr;
+}
+
+std::string UdpSocket::sender() const {
+    if (m_peer_size < sizeof(sockaddr_in))
+        return "unknown";
+    const sockaddr_in* last = reinterpret_cast<const sockaddr_in*>(m_peer);
+    char ip[INET_ADDRSTRLEN] = {0};
+    ::inet_ntop(AF_INET, &last->sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(last->sin_port));
+}
+
+#else
+
+bool UdpSocket::bind(const std::string&, unsigned short) {
+    LOG(Error) << "UdpSocket requires POSIX sockets, which are not available on this platform.";
+    return false;
+}
+
+bool UdpSocket::connect(const std::string&, unsigned short) {
+    LOG(Error) << "UdpSocket requires POSIX sockets, which are not available on this platform.";
+    return false;
+}
+
+void UdpSocket::close() { }
+
+unsigned short UdpSocket::port() const {
+    return 0;
+}
+
+bool UdpSocket::send(const void*, std::size_t) {
+    return false;
+}
+
+long UdpSocket::receive(void*, std::size_t, Time) {
+    return -1;
+}
+
+void UdpSocket::set_peer() { }
+
+bool UdpSocket::from_peer() const {
+    return false;
+}
+
+std::string UdpSocket::sender() const {
+    return "unknown";
+}
+
+#endif
+
+} // namespace daq
+} // namespace mahi
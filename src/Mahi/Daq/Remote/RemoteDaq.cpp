@@ -0,0 +1,341 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Remote/RemoteDaq.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <chrono>
+#include <map>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+/// Returns the steady clock in [ns]
+inline std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const std::size_t npos = static_cast<std::size_t>(-1);
+
+} // private namespace
+
+//==============================================================================
+// MODULES
+//==============================================================================
+
+RemoteAI::RemoteAI(RemoteDaq& d, const TraceStream& layout, std::size_t input) :
+    RemoteModule<AIModule>(d, layout, input, npos) {
+    bind_read<RemoteAI, Volts, &RemoteAI::read_impl>(*this);
+}
+
+RemoteAO::RemoteAO(RemoteDaq& d, const TraceStream& layout, std::size_t output) :
+    RemoteModule<AOModule>(d, layout, npos, output) {
+    bind_write<RemoteAO, Volts, &RemoteAO::write_impl>(*this);
+}
+
+RemoteDI::RemoteDI(RemoteDaq& d, const TraceStream& layout, std::size_t input) :
+    RemoteModule<DIModule>(d, layout, input, npos) {
+    bind_read<RemoteDI, TTL, &RemoteDI::read_impl>(*this);
+}
+
+RemoteDO::RemoteDO(RemoteDaq& d, const TraceStream& layout, std::size_t output) :
+    RemoteModule<DOModule>(d, layout, npos, output) {
+    bind_write<RemoteDO, TTL, &RemoteDO::write_impl>(*this);
+}
+
+RemoteEncoder::RemoteEncoder(RemoteDaq& d, const TraceStream& layout, std::size_t input, std::size_t output) :
+    RemoteModule<EncoderModule>(d, layout, input, output) {
+    bind_read<RemoteEncoder, Counts, &RemoteEncoder::read_impl>(*this);
+    bind_write<RemoteEncoder, Counts, &RemoteEncoder::write_impl>(*this);
+    // quadrature modes are configured on the server
+    connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+}
+
+//==============================================================================
+// REMOTEDAQ
+//==============================================================================
+
+RemoteDaq::RemoteDaq(const std::string& host, unsigned short port, bool auto_open) :
+    Daq("remote_daq"),
+    m_connected(false),
+    m_in_bytes(0),
+    m_tx(RemoteMaxDatagram, 0),
+    m_rx(RemoteMaxDatagram, 0),
+    m_seq(0),
+    m_timeout(milliseconds(100)),
+    m_retries(3),
+    m_exchanges(0),
+    m_retransmissions(0),
+    m_round_trip_ns(0),
+    m_server_ns(0)
+{
+    if (m_socket.connect(host, port))
+        m_connected = describe();
+    if (!m_connected)
+        LOG(Error) << "Failed to connect " << name() << " to a DaqServer at " << host << ":" << port << ".";
+    if (auto_open)
+        open();
+}
+
+RemoteDaq::~RemoteDaq() {
+    if (is_enabled())
+        disable();
+    if (is_open())
+        close();
+}
+
+bool RemoteDaq::on_daq_open() {
+    return m_connected;
+}
+
+bool RemoteDaq::is_connected() const {
+    return m_connected;
+}
+
+bool RemoteDaq::read_all() {
+    LatencyTimer timer(read_all_latency());
+    if (!exchange(RemoteMessage::Cycle, RemoteRead, 0))
+        return false;
+    received();
+    return true;
+}
+
+bool RemoteDaq::write_all() {
+    LatencyTimer timer(write_all_latency());
+    if (!exchange(RemoteMessage::Cycle, RemoteWrite, pack(true, 0, nullptr)))
+        return false;
+    for (auto& l : m_outputs) {
+        if (l.module && l.with_all(l.module))
+            l.sent(l.module);
+    }
+    capture_outputs();
+    return true;
+}
+
+bool RemoteDaq::write_read_all() {
+    // the one exchange is both this cycle's write_all and read_all
+    LatencyTimer timer(read_all_latency());
+    bool ok = exchange(RemoteMessage::Cycle, RemoteWrite | RemoteRead, pack(true, 0, nullptr));
+    write_all_latency().record(timer.elapsed_ns());
+    if (!ok)
+        return false;
+    for (auto& l : m_outputs) {
+        if (l.module && l.with_all(l.module))
+            l.sent(l.module);
+    }
+    capture_outputs();
+    received();
+    return true;
+}
+
+void RemoteDaq::set_timeout(Time timeout, int retries) {
+    m_timeout = timeout;
+    m_retries = retries < 0 ? 0 : retries;
+}
+
+std::uint64_t RemoteDaq::exchanges() const {
+    return m_exchanges;
+}
+
+std::uint64_t RemoteDaq::retransmissions() const {
+    return m_retransmissions;
+}
+
+Time RemoteDaq::round_trip() const {
+    return microseconds(m_round_trip_ns / 1000);
+}
+
+Time RemoteDaq::server_time() const {
+    return microseconds(m_server_ns / 1000);
+}
+
+bool RemoteDaq::describe() {
+    if (!exchange(RemoteMessage::Describe, 0, 0))
+        return false;
+    RemoteHeader reply;
+    std::memcpy(&reply, &m_rx[0], sizeof(RemoteHeader));
+    if (reply.type != RemoteMessage::Schema || !decode_schema(&m_rx[sizeof(RemoteHeader)], reply.size, m_schema)) {
+        LOG(Error) << "DaqServer sent a malformed schema to " << name() << ".";
+        return false;
+    }
+    // index the streams; inputs are laid out back to back in State payloads
+    const Link  none   = {nullptr, 0, 0, nullptr, nullptr, nullptr, nullptr};
+    std::size_t offset = 0;
+    std::vector<std::size_t> index(m_schema.size());
+    for (std::size_t s = 0; s < m_schema.size(); ++s) {
+        Link l  = none;
+        l.bytes = m_schema[s].size * m_schema[s].channels.size();
+        if (m_schema[s].output) {
+            index[s] = m_outputs.size();
+            m_outputs.push_back(l);
+        }
+        else {
+            l.offset = offset;
+            offset  += l.bytes;
+            index[s] = m_inputs.size();
+            m_inputs.push_back(l);
+        }
+    }
+    m_in_bytes = offset;
+    // the first input and first output stream of each Module determine what it becomes
+    std::vector<std::string> order;
+    std::map<std::string, std::pair<int, int>> found;
+    for (std::size_t s = 0; s < m_schema.size(); ++s) {
+        auto it = found.find(m_schema[s].module);
+        if (it == found.end()) {
+            order.push_back(m_schema[s].module);
+            it = found.insert(std::make_pair(m_schema[s].module, std::make_pair(-1, -1))).first;
+        }
+        int& slot = m_schema[s].output ? it->second.second : it->second.first;
+        if (slot == -1)
+            slot = static_cast<int>(s);
+    }
+    for (auto& module : order) {
+        int in = found[module].first, out = found[module].second;
+        const TraceStream* i = in != -1 ? &m_schema[in] : nullptr;
+        const TraceStream* o = out != -1 ? &m_schema[out] : nullptr;
+        if (i && i->type == TraceType::Float64 && i->size == sizeof(Volts)) {
+            auto m = new RemoteAI(*this, *i, index[in]);
+            m_mirrored.emplace_back(m);
+            link_input(m, index[in]);
+        }
+        else if (i && i->type == TraceType::Int8 && i->size == sizeof(TTL)) {
+            auto m = new RemoteDI(*this, *i, index[in]);
+            m_mirrored.emplace_back(m);
+            link_input(m, index[in]);
+        }
+        else if (i && i->type == TraceType::Int32 && i->size == sizeof(Counts)) {
+            bool counts = o && o->type == TraceType::Int32 && o->channels == i->channels;
+            auto m = new RemoteEncoder(*this, *i, index[in], counts ? index[out] : npos);
+            m_mirrored.emplace_back(m);
+            link_input(m, index[in]);
+            if (counts)
+                link_output(m, index[out]);
+        }
+        else if (!i && o->type == TraceType::Float64 && o->size == sizeof(Volts)) {
+            auto m = new RemoteAO(*this, *o, index[out]);
+            m_mirrored.emplace_back(m);
+            link_output(m, index[out]);
+        }
+        else if (!i && o->type == TraceType::Int8 && o->size == sizeof(TTL)) {
+            auto m = new RemoteDO(*this, *o, index[out]);
+            m_mirrored.emplace_back(m);
+            link_output(m, index[out]);
+        }
+        else
+            LOG(Warning) << "Cannot mirror " << module << " because its value types are not supported.";
+    }
+    LOG(Verbose) << "Connected " << name() << " to a DaqServer with " << m_mirrored.size() << " Modules.";
+    return true;
+}
+
+std::size_t RemoteDaq::pack(bool all, std::size_t only, const void* values) {
+    char* begin = &m_tx[sizeof(RemoteHeader)];
+    char* p     = begin;
+    for (std::size_t i = 0; i < m_outputs.size(); ++i) {
+        Link& l = m_outputs[i];
+        bool present = all ? l.module && l.with_all(l.module) : i == only;
+        *p++ = present ? 1 : 0;
+        if (present) {
+            if (all)
+                l.send(l.module, p);
+            else
+                std::memcpy(p, values, l.bytes);
+            p += l.bytes;
+        }
+    }
+    return static_cast<std::size_t>(p - begin);
+}
+
+bool RemoteDaq::exchange(RemoteMessage type, std::uint8_t flags, std::size_t payload) {
+    RemoteHeader request;
+    request.magic     = RemoteMagic;
+    request.type      = type;
+    request.flags     = flags;
+    request.reserved  = 0;
+    request.seq       = ++m_seq;
+    request.size      = static_cast<std::uint32_t>(payload);
+    request.server_ns = 0;
+    const std::int64_t timeout_ns = m_timeout.as_microseconds() * 1000;
+    for (int attempt = 0; attempt <= m_retries; ++attempt) {
+        if (attempt > 0)
+            ++m_retransmissions;
+        request.client_ns = now_ns();
+        std::memcpy(&m_tx[0], &request, sizeof(RemoteHeader));
+        if (!m_socket.send(&m_tx[0], sizeof(RemoteHeader) + payload))
+            return false;
+        const std::int64_t deadline = request.client_ns + timeout_ns;
+        for (std::int64_t now = now_ns(); now < deadline; now = now_ns()) {
+            long got = m_socket.receive(&m_rx[0], m_rx.size(), microseconds((deadline - now + 999) / 1000));
+            if (got < 0)
+                return false;
+            if (got == 0)
+                break;
+            RemoteHeader reply;
+            if (static_cast<std::size_t>(got) < sizeof(RemoteHeader))
+                continue;
+            std::memcpy(&reply, &m_rx[0], sizeof(RemoteHeader));
+            // ignore late replies to earlier requests
+            if (reply.magic != RemoteMagic || reply.seq != request.seq || reply.size != got - sizeof(RemoteHeader))
+                continue;
+            m_round_trip_ns = now_ns() - reply.client_ns;
+            m_server_ns     = reply.server_ns;
+            m_round_trip_latency.record(static_cast<std::uint64_t>(m_round_trip_ns));
+            ++m_exchanges;
+            if (reply.flags & RemoteFailed) {
+                LOG(Error) << "DaqServer of " << name() << " failed to " << (flags & RemoteWrite ? "write" : "read") << ".";
+                return false;
+            }
+            // inputs are copied out by schema offsets, so a State of any other size is not ours
+            if ((flags & RemoteRead) && (reply.type != RemoteMessage::State || reply.size != m_in_bytes)) {
+                LOG(Error) << "DaqServer of " << name() << " sent " << reply.size << " bytes of inputs instead of "
+                           << m_in_bytes << ". Its channels may have changed since it was described.";
+                return false;
+            }
+            return true;
+        }
+    }
+    LOG(Error) << "DaqServer of " << name() << " did not answer within " << m_retries + 1 << " attempts.";
+    return false;
+}
+
+const char* RemoteDaq::fetch(std::size_t i) {
+    if (!exchange(RemoteMessage::Cycle, RemoteRead, 0))
+        return nullptr;
+    return &m_rx[sizeof(RemoteHeader) + m_inputs[i].offset];
+}
+
+bool RemoteDaq::push(std::size_t i, const void* values) {
+    if (i >= m_outputs.size()) {
+        LOG(Error) << "Cannot write because the DaqServer of " << name() << " does not serve this output.";
+        return false;
+    }
+    return exchange(RemoteMessage::Cycle, RemoteWrite, pack(false, i, values));
+}
+
+void RemoteDaq::received() {
+    for (auto& l : m_inputs) {
+        if (l.module && l.with_all(l.module))
+            l.receive(l.module, &m_rx[sizeof(RemoteHeader) + l.offset]);
+    }
+    capture_inputs();
+}
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,267 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Replay/ReplayDaq.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+/// Returns the recorded internal channels sorted, for ChanMap
+ChanNums sorted(ChanNums chs) {
+    std::sort(chs.begin(), chs.end());
+    chs.erase(std::unique(chs.begin(), chs.end()), chs.end());
+    return chs;
+}
+
+}  // namespace
+
+//==============================================================================
+// STREAMS
+//==============================================================================
+
+ReplayCursor::ReplayCursor(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records) :
+    m_daq(daq), m_records(records), m_cursor(0), m_map(sorted(stream.internal))
+{ }
+
+template <typename T>
+ReplaySource<T>::ReplaySource(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records) :
+    ReplayCursor(daq, stream, records), m_last(m_map.size(), T())
+{ }
+
+template <typename T>
+bool ReplaySource<T>::read(const ChanNum* chs, T* values, std::size_t n) {
+    if (finished())
+        return false;
+    const TraceReader::Record& rec = m_records[m_cursor++];
+    const T* recorded = static_cast<const T*>(rec.values);
+    for (std::size_t j = 0; j < rec.n; ++j) {
+        std::size_t k = m_map.find(rec.channels[j]);
+        if (k != ChanMap::npos)
+            m_last[k] = recorded[j];
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t k = m_map.find(chs[i]);
+        values[i] = k != ChanMap::npos ? m_last[k] : T();
+    }
+    m_daq.m_time_ns = rec.time_ns;
+    return true;
+}
+
+template <typename T>
+ReplaySink<T>::ReplaySink(ReplayDaq& daq, const TraceStream& stream, const std::vector<TraceReader::Record>& records) :
+    ReplayCursor(daq, stream, records)
+{ }
+
+template <typename T>
+bool ReplaySink<T>::write(const ChanNum* chs, const T* values, std::size_t n) {
+    if (finished()) {
+        for (std::size_t i = 0; i < n; ++i)
+            m_daq.compare(0, false);
+        return true;
+    }
+    const TraceReader::Record& rec = m_records[m_cursor++];
+    const T* recorded = static_cast<const T*>(rec.values);
+    for (std::size_t i = 0; i < n; ++i) {
+        // writes are usually recorded in the same channel order, so try i first
+        std::size_t j = i < rec.n && rec.channels[i] == chs[i] ? i : rec.n;
+        for (std::size_t s = 0; j == rec.n && s < rec.n; ++s) {
+            if (rec.channels[s] == chs[i])
+                j = s;
+        }
+        if (j < rec.n)
+            m_daq.compare(std::fabs(static_cast<double>(values[i]) - static_cast<double>(recorded[j])), true);
+        else
+            m_daq.compare(0, false);
+    }
+    return true;
+}
+
+//==============================================================================
+// MODULES
+//==============================================================================
+
+ReplayAI::ReplayAI(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records) :
+    ReplayModule<AIModule>(d, in), source(d, in, records) {
+    bind_read<ReplayAI, Volts, &ReplayAI::read_impl>(*this);
+}
+
+ReplayAO::ReplayAO(ReplayDaq& d, const TraceStream& out, const std::vector<TraceReader::Record>& records) :
+    ReplayModule<AOModule>(d, out), sink(d, out, records) {
+    bind_write<ReplayAO, Volts, &ReplayAO::write_impl>(*this);
+}
+
+ReplayDI::ReplayDI(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records) :
+    ReplayModule<DIModule>(d, in), source(d, in, records) {
+    bind_read<ReplayDI, TTL, &ReplayDI::read_impl>(*this);
+}
+
+ReplayDO::ReplayDO(ReplayDaq& d, const TraceStream& out, const std::vector<TraceReader::Record>& records) :
+    ReplayModule<DOModule>(d, out), sink(d, out, records) {
+    bind_write<ReplayDO, TTL, &ReplayDO::write_impl>(*this);
+}
+
+ReplayEncoder::ReplayEncoder(ReplayDaq& d, const TraceStream& in, const std::vector<TraceReader::Record>& records,
+                             const TraceStream* out, const std::vector<TraceReader::Record>* out_records) :
+    ReplayModule<EncoderModule>(d, in), source(d, in, records) {
+    if (out)
+        sink.reset(new ReplaySink<Counts>(d, *out, *out_records));
+    bind_read<ReplayEncoder, Counts, &ReplayEncoder::read_impl>(*this);
+    bind_write<ReplayEncoder, Counts, &ReplayEncoder::write_impl>(*this);
+    connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+}
+
+//==============================================================================
+// REPLAYDAQ
+//==============================================================================
+
+ReplayDaq::ReplayDaq(const std::string& trace, bool auto_open) :
+    Daq("replay_daq"),
+    m_loaded(false),
+    m_time_ns(0),
+    m_tolerance(0),
+    m_compared(0),
+    m_mismatches(0),
+    m_max_error(0)
+{
+    m_loaded = m_trace.load(trace);
+    if (m_loaded) {
+        // the first readable and first writeable stream of each Module determine what it becomes
+        const auto& streams = m_trace.streams();
+        std::vector<std::string> order;
+        std::map<std::string, std::pair<int, int>> found;
+        for (std::size_t s = 0; s < streams.size(); ++s) {
+            auto it = found.find(streams[s].module);
+            if (it == found.end()) {
+                order.push_back(streams[s].module);
+                it = found.insert(std::make_pair(streams[s].module, std::make_pair(-1, -1))).first;
+            }
+            int& slot = streams[s].output ? it->second.second : it->second.first;
+            if (slot == -1 && streams[s].type != TraceType::Opaque)
+                slot = static_cast<int>(s);
+        }
+        for (auto& name : order) {
+            int in = found[name].first, out = found[name].second;
+            const TraceStream* i = in != -1 ? &streams[in] : nullptr;
+            const TraceStream* o = out != -1 ? &streams[out] : nullptr;
+            if ((i && i->channels.empty()) || (!i && (!o || o->channels.empty()))) {
+                LOG(Verbose) << "Not replaying " << name << " because it has no traced channels.";
+                continue;
+            }
+            if (i && i->type == TraceType::Float64 && i->size == sizeof(Volts)) {
+                auto m = new ReplayAI(*this, *i, m_trace.records(in));
+                m_replayed.emplace_back(m);
+                m_inputs.push_back(&m->source);
+            }
+            else if (i && i->type == TraceType::Int8 && i->size == sizeof(TTL)) {
+                auto m = new ReplayDI(*this, *i, m_trace.records(in));
+                m_replayed.emplace_back(m);
+                m_inputs.push_back(&m->source);
+            }
+            else if (i && i->type == TraceType::Int32 && i->size == sizeof(Counts)) {
+                bool counts = o && o->type == TraceType::Int32 && o->channels == i->channels;
+                auto m = new ReplayEncoder(*this, *i, m_trace.records(in), counts ? o : nullptr,
+                                           counts ? &m_trace.records(out) : nullptr);
+                m_replayed.emplace_back(m);
+                m_inputs.push_back(&m->source);
+                if (m->sink)
+                    m_outputs.push_back(m->sink.get());
+            }
+            else if (!i && o->type == TraceType::Float64 && o->size == sizeof(Volts)) {
+                auto m = new ReplayAO(*this, *o, m_trace.records(out));
+                m_replayed.emplace_back(m);
+                m_outputs.push_back(&m->sink);
+            }
+            else if (!i && o->type == TraceType::Int8 && o->size == sizeof(TTL)) {
+                auto m = new ReplayDO(*this, *o, m_trace.records(out));
+                m_replayed.emplace_back(m);
+                m_outputs.push_back(&m->sink);
+            }
+            else
+                LOG(Warning) << "Cannot replay " << name << " because its traced value types are not supported.";
+        }
+        LOG(Verbose) << "Loaded trace " << trace << " with " << m_replayed.size() << " replayable Modules.";
+    }
+    if (auto_open)
+        open();
+}
+
+ReplayDaq::~ReplayDaq() {
+    if (is_enabled())
+        disable();
+    if (is_open())
+        close();
+}
+
+bool ReplayDaq::is_loaded() const {
+    return m_loaded;
+}
+
+bool ReplayDaq::finished() const {
+    for (auto& c : m_inputs) {
+        if (c->finished())
+            return true;
+    }
+    return false;
+}
+
+void ReplayDaq::rewind() {
+    for (auto& c : m_inputs)
+        c->rewind();
+    for (auto& c : m_outputs)
+        c->rewind();
+    m_time_ns    = 0;
+    m_compared   = 0;
+    m_mismatches = 0;
+    m_max_error  = 0;
+}
+
+Time ReplayDaq::time() const {
+    return microseconds(m_time_ns / 1000);
+}
+
+void ReplayDaq::set_tolerance(double tolerance) {
+    m_tolerance = tolerance;
+}
+
+std::uint64_t ReplayDaq::outputs_compared() const {
+    return m_compared;
+}
+
+std::uint64_t ReplayDaq::output_mismatches() const {
+    return m_mismatches;
+}
+
+double ReplayDaq::max_output_error() const {
+    return m_max_error;
+}
+
+template class ReplaySource<Volts>;
+template class ReplaySource<TTL>;
+template class ReplaySource<Counts>;
+template class ReplaySink<Volts>;
+template class ReplaySink<TTL>;
+template class ReplaySink<Counts>;
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,365 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Shm.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cerrno>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAHI_DAQ_POSIX_SHM
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+/// The fixed header at the start of a segment
+struct SegmentHeader {
+    char                       magic[8];   ///< "MAHISHM1"
+    std::uint32_t              count;      ///< number of SegmentChannels
+    std::uint32_t              data_size;  ///< size of the data block in bytes
+    std::atomic<std::uint64_t> sequence;   ///< seqlock sequence, odd while being written
+};
+
+/// A schema entry following the SegmentHeader
+struct SegmentChannel {
+    char          module[64];  ///< null terminated Module name
+    std::uint32_t channel;     ///< public channel number
+    std::uint32_t type;        ///< ShmType
+    std::uint32_t offset;      ///< byte offset of the value within the data block
+    std::uint32_t reserved;    ///< padding
+};
+
+const char        s_magic[8]   = {'M', 'A', 'H', 'I', 'S', 'H', 'M', '1'};
+const std::size_t s_alignment  = 64;  ///< alignment of the data block
+const std::size_t s_stamp_size = 16;  ///< uint64 cycle and int64 time at the start of the data block
+
+inline std::size_t align_up(std::size_t n, std::size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+inline std::size_t data_offset(std::size_t count) {
+    return align_up(sizeof(SegmentHeader) + count * sizeof(SegmentChannel), s_alignment);
+}
+
+inline std::string posix_name(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+inline std::size_t size_of(ShmType type) {
+    return type == ShmType::Float64 ? 8 : type == ShmType::Int32 ? 4 : 1;
+}
+
+} // private namespace
+
+//==============================================================================
+// ShmPublisher
+//==============================================================================
+
+ShmPublisher::ShmPublisher(const std::string& name) :
+    m_name(name),
+    m_data_size(s_stamp_size),
+    m_segment(nullptr),
+    m_size(0),
+    m_data(nullptr),
+    m_sequence(nullptr),
+    m_cycle(0)
+{ }
+
+ShmPublisher::~ShmPublisher() {
+    close();
+}
+
+bool ShmPublisher::add_buffer(const void* buffer, void (*copy)(const void*, void*, std::size_t),
+                              const ChanneledModule& module, ShmType type, std::size_t size) 
+{
+    if (is_open()) {
+        LOG(Error) << "Cannot add " << module.name() << " to ShmPublisher " << m_name << " because it is already open.";
+        return false;
+    }
+    Source s;
+    s.buffer = buffer;
+    s.copy   = copy;
+    s.offset = align_up(m_data_size, size);
+    s.bytes  = module.channels().size() * size;
+    m_sources.push_back(s);
+    for (std::size_t i = 0; i < module.channels().size(); ++i) {
+        ShmChannel c;
+        c.module  = module.name();
+        c.channel = module.channels()[i];
+        c.type    = type;
+        c.offset  = s.offset + i * size;
+        m_channels.push_back(c);
+    }
+    m_data_size = s.offset + s.bytes;
+    return true;
+}
+
+#ifdef MAHI_DAQ_POSIX_SHM
+
+bool ShmPublisher::open() {
+    if (is_open())
+        return true;
+    std::string name = posix_name(m_name);
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        LOG(Error) << "Failed to create shared memory " << name << " (" << std::strerror(errno) << ").";
+        return false;
+    }
+    std::size_t offset = data_offset(m_channels.size());
+    std::size_t size   = offset + m_data_size;
+    if (ftruncate(fd, static_cast<off_t>(size)) == -1) {
+        LOG(Error) << "Failed to size shared memory " << name << " (" << std::strerror(errno) << ").";
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        LOG(Error) << "Failed to map shared memory " << name << " (" << std::strerror(errno) << ").";
+        shm_unlink(name.c_str());
+        return false;
+    }
+    std::memset(segment, 0, size);
+    // write the schema, then the magic last so readers never see a partial header
+    auto header = static_cast<SegmentHeader*>(segment);
+    header->count     = static_cast<std::uint32_t>(m_channels.size());
+    header->data_size = static_cast<std::uint32_t>(m_data_size);
+    m_sequence = new (&header->sequence) std::atomic<std::uint64_t>(0);
+    auto entries = reinterpret_cast<SegmentChannel*>(header + 1);
+    for (std::size_t i = 0; i < m_channels.size(); ++i) {
+        std::strncpy(entries[i].module, m_channels[i].module.c_str(), sizeof(entries[i].module) - 1);
+        entries[i].channel = m_channels[i].channel;
+        entries[i].type    = static_cast<std::uint32_t>(m_channels[i].type);
+        entries[i].offset  = static_cast<std::uint32_t>(m_channels[i].offset);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, s_magic, sizeof(s_magic));
+    m_segment = segment;
+    m_size    = size;
+    m_data    = static_cast<unsigned char*>(segment) + offset;
+    m_cycle   = 0;
+    LOG(Verbose) << "Opened ShmPublisher " << name << " with " << m_channels.size() << " channels.";
+    return true;
+}
+
+void ShmPublisher::close() {
+    if (!is_open())
+        return;
+    munmap(m_segment, m_size);
+    shm_unlink(posix_name(m_name).c_str());
+    m_segment  = nullptr;
+    m_data     = nullptr;
+    m_sequence = nullptr;
+}
+
+#else
+
+bool ShmPublisher::open() {
+    LOG(Error) << "ShmPublisher requires POSIX shared memory, which is not available on this platform.";
+    return false;
+}
+
+void ShmPublisher::close() { }
+
+#endif
+
+bool ShmPublisher::is_open() const {
+    return m_segment != nullptr;
+}
+
+bool ShmPublisher::publish(Time t) {
+    if (!is_open())
+        return false;
+    // seqlock: an odd sequence tells readers a write is in progress
+    std::uint64_t seq = m_sequence->load(std::memory_order_relaxed);
+    m_sequence->store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::uint64_t cycle = ++m_cycle;
+    std::int64_t  us    = t.as_microseconds();
+    std::memcpy(m_data, &cycle, 8);
+    std::memcpy(m_data + 8, &us, 8);
+    for (auto& s : m_sources)
+        s.copy(s.buffer, m_data + s.offset, s.bytes);
+    m_sequence->store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t ShmPublisher::published() const {
+    return m_cycle;
+}
+
+const std::vector<ShmChannel>& ShmPublisher::channels() const {
+    return m_channels;
+}
+
+//==============================================================================
+// ShmReader
+//==============================================================================
+
+ShmReader::ShmReader() :
+    m_segment(nullptr),
+    m_size(0),
+    m_data(nullptr),
+    m_sequence(nullptr)
+{ }
+
+ShmReader::~ShmReader() {
+    close();
+}
+
+#ifdef MAHI_DAQ_POSIX_SHM
+
+bool ShmReader::open(const std::string& name) {
+    close();
+    std::string pname = posix_name(name);
+    int fd = shm_open(pname.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        LOG(Error) << "Failed to open shared memory " << pname << " (" << std::strerror(errno) << ").";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<std::size_t>(st.st_size) < sizeof(SegmentHeader)) {
+        LOG(Error) << "Shared memory " << pname << " is not a mahi::daq segment.";
+        ::close(fd);
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(st.st_size);
+    void* segment = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        LOG(Error) << "Failed to map shared memory " << pname << " (" << std::strerror(errno) << ").";
+        return false;
+    }
+    auto header = static_cast<const SegmentHeader*>(segment);
+    std::size_t offset = data_offset(header->count);
+    if (std::memcmp(header->magic, s_magic, sizeof(s_magic)) != 0 || offset + header->data_size > size) {
+        LOG(Error) << "Shared memory " << pname << " is not a mahi::daq segment.";
+        munmap(segment, size);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    auto entries = reinterpret_cast<const SegmentChannel*>(header + 1);
+    m_channels.resize(header->count);
+    for (std::size_t i = 0; i < m_channels.size(); ++i) {
+        m_channels[i].module  = std::string(entries[i].module, strnlen(entries[i].module, sizeof(entries[i].module)));
+        m_channels[i].channel = entries[i].channel;
+        m_channels[i].type    = static_cast<ShmType>(entries[i].type);
+        m_channels[i].offset  = entries[i].offset;
+    }
+    m_frame.assign(header->data_size, 0);
+    m_segment  = segment;
+    m_size     = size;
+    m_data     = static_cast<const unsigned char*>(segment) + offset;
+    m_sequence = &header->sequence;
+    return true;
+}
+
+void ShmReader::close() {
+    if (!is_open())
+        return;
+    munmap(m_segment, m_size);
+    m_segment  = nullptr;
+    m_data     = nullptr;
+    m_sequence = nullptr;
+    m_channels.clear();
+    m_frame.clear();
+}
+
+#else
+
+bool ShmReader::open(const std::string&) {
+    LOG(Error) << "ShmReader requires POSIX shared memory, which is not available on this platform.";
+    return false;
+}
+
+void ShmReader::close() { }
+
+#endif
+
+bool ShmReader::is_open() const {
+    return m_segment != nullptr;
+}
+
+bool ShmReader::update() {
+    if (!is_open())
+        return false;
+    const std::uint64_t last = cycle();
+    // retry until a copy is not torn by a concurrent publish
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        std::uint64_t before = m_sequence->load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::memcpy(m_frame.data(), m_data, m_frame.size());
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence->load(std::memory_order_relaxed) == before)
+            return cycle() != last;
+    }
+    return false;
+}
+
+std::uint64_t ShmReader::cycle() const {
+    std::uint64_t cycle = 0;
+    if (m_frame.size() >= s_stamp_size)
+        std::memcpy(&cycle, m_frame.data(), 8);
+    return cycle;
+}
+
+Time ShmReader::time() const {
+    std::int64_t us = 0;
+    if (m_frame.size() >= s_stamp_size)
+        std::memcpy(&us, m_frame.data() + 8, 8);
+    return microseconds(us);
+}
+
+const std::vector<ShmChannel>& ShmReader::channels() const {
+    return m_channels;
+}
+
+double ShmReader::value(std::size_t i) const {
+    if (i >= m_channels.size() || m_channels[i].offset + size_of(m_channels[i].type) > m_frame.size())
+        return 0;
+    const unsigned char* p = m_frame.data() + m_channels[i].offset;
+    switch (m_channels[i].type) {
+        case ShmType::Float64: { double v;       std::memcpy(&v, p, 8); return v; }
+        case ShmType::Int32:   { std::int32_t v; std::memcpy(&v, p, 4); return v; }
+        case ShmType::Int8:    { std::int8_t v;  std::memcpy(&v, p, 1); return v; }
+    }
+    return 0;
+}
+
+int ShmReader::find(const std::string& module, ChanNum ch) const {
+    for (std::size_t i = 0; i < m_channels.size(); ++i) {
+        if (m_channels[i].module == module && m_channels[i].channel == ch)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+} // namespace daq
+} // namespace mahi
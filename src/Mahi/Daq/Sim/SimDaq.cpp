@@ -0,0 +1,256 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Sim/SimDaq.hpp>
+#include <chrono>
+#include <thread>
+
+namespace mahi {
+namespace daq {
+
+//==============================================================================
+// MODULES
+//==============================================================================
+
+SimAI::SimAI(SimDaq& d, const ChanNums& allowed) : AIModule(d, allowed), m_daq(d) {
+    set_name(d.name() + ".AI");
+    bind_read<SimAI, Volts, &SimAI::read_impl>(*this);
+}
+
+bool SimAI::read_impl(const ChanNum* chs, Volts* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i)
+        vals[i] = m_daq.m_analog[chs[i]];
+    return true;
+}
+
+SimAO::SimAO(SimDaq& d, const ChanNums& allowed) : AOModule(d, allowed), m_daq(d) {
+    set_name(d.name() + ".AO");
+    bind_write<SimAO, Volts, &SimAO::write_impl>(*this);
+}
+
+bool SimAO::write_impl(const ChanNum* chs, const Volts* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i)
+        m_daq.m_analog[chs[i]] = vals[i];
+    return true;
+}
+
+SimDI::SimDI(SimDaq& d, const ChanNums& allowed) : DIModule(d, allowed), m_daq(d) {
+    set_name(d.name() + ".DI");
+    bind_read<SimDI, TTL, &SimDI::read_impl>(*this);
+}
+
+bool SimDI::read_impl(const ChanNum* chs, TTL* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i)
+        vals[i] = m_daq.m_digital[chs[i]];
+    return true;
+}
+
+SimDO::SimDO(SimDaq& d, const ChanNums& allowed) : DOModule(d, allowed), m_daq(d) {
+    set_name(d.name() + ".DO");
+    bind_write<SimDO, TTL, &SimDO::write_impl>(*this);
+}
+
+bool SimDO::write_impl(const ChanNum* chs, const TTL* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i)
+        m_daq.m_digital[chs[i]] = vals[i];
+    return true;
+}
+
+SimEncoder::SimEncoder(SimDaq& d, const ChanNums& allowed) :
+    EncoderModule(d, allowed), increments(*this, 0), m_daq(d), m_counts(8, 0) {
+    set_name(d.name() + ".encoder");
+    bind_read<SimEncoder, Counts, &SimEncoder::read_impl>(*this);
+    bind_write<SimEncoder, Counts, &SimEncoder::write_impl>(*this);
+    connect_write(modes, [](const ChanNum*, const QuadMode*, std::size_t) { return true; });
+}
+
+bool SimEncoder::read_impl(const ChanNum* chs, Counts* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i) {
+        m_counts[chs[i]] += increments[chs[i]];
+        vals[i] = m_counts[chs[i]];
+    }
+    return true;
+}
+
+bool SimEncoder::write_impl(const ChanNum* chs, const Counts* vals, std::size_t n) {
+    auto transaction = m_daq.transact();
+    for (std::size_t i = 0; i < n; ++i)
+        m_counts[chs[i]] = vals[i];
+    return true;
+}
+
+SimStreamingAI::SimStreamingAI(SimDaq& d, const ChanNums& allowed) :
+    StreamingAIModule(d, allowed), m_daq(d), m_rate(1), m_capacity(1), m_consumed(0) {
+    set_name(d.name() + ".stream");
+}
+
+bool SimStreamingAI::on_stream_start(const ChanNums& chs, double hz, std::size_t buffer_scans) {
+    auto transaction = m_daq.transact();
+    m_chs      = chs;
+    m_rate     = hz;
+    m_capacity = buffer_scans;
+    m_start    = std::chrono::steady_clock::now();
+    m_consumed = 0;
+    return true;
+}
+
+bool SimStreamingAI::on_stream_stop() {
+    auto transaction = m_daq.transact();
+    return true;
+}
+
+std::size_t SimStreamingAI::on_read_block(Volts* samples, std::size_t max_scans, std::uint64_t& lost) {
+    auto transaction = m_daq.transact();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+    std::uint64_t acquired  = static_cast<std::uint64_t>(elapsed.count() * m_rate);
+    std::uint64_t available = acquired - m_consumed;
+    lost = 0;
+    if (available > m_capacity) {
+        lost        = available - m_capacity;
+        m_consumed += lost;
+        available   = m_capacity;
+    }
+    std::size_t scans = available < max_scans ? static_cast<std::size_t>(available) : max_scans;
+    for (std::size_t s = 0; s < scans; ++s) {
+        for (std::size_t i = 0; i < m_chs.size(); ++i)
+            samples[s * m_chs.size() + i] = m_daq.m_analog[m_chs[i]];
+    }
+    m_consumed += scans;
+    return scans;
+}
+
+//==============================================================================
+// SIMDAQ
+//==============================================================================
+
+SimDaq::SimDaq(const SimLatency& latency, bool auto_open) :
+    Daq("sim_daq"),
+    m_latency(latency),
+    m_rng(std::random_device()()),
+    m_jitter(0, 1),
+    m_synced(false),
+    m_transactions(0),
+    m_analog(8, 0),
+    m_digital(8, TTL_LOW),
+    AI(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+    AO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+    DI(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+    DO(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+    encoder(*this, {0, 1, 2, 3, 4, 5, 6, 7}),
+    stream(*this, {0, 1, 2, 3, 4, 5, 6, 7})
+{
+    AI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    AO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    DI.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    DO.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    encoder.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    stream.set_channels({0, 1, 2, 3, 4, 5, 6, 7});
+    if (auto_open)
+        open();
+}
+
+SimDaq::~SimDaq() {
+    if (is_enabled())
+        disable();
+    if (is_open())
+        close();
+}
+
+bool SimDaq::read_all() {
+    if (is_pipelined())
+        return Daq::read_all();
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    wait_latency();
+    m_synced = true;
+    bool success = Daq::read_all();
+    m_synced = false;
+    return success;
+}
+
+bool SimDaq::write_all() {
+    if (is_pipelined())
+        return Daq::write_all();
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    wait_latency();
+    m_synced = true;
+    bool success = Daq::write_all();
+    m_synced = false;
+    return success;
+}
+
+bool SimDaq::write_read_all() {
+    if (is_pipelined())
+        return Daq::write_read_all();
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    wait_latency();
+    m_synced = true;
+    bool written = Daq::write_all();
+    bool read    = Daq::read_all();
+    m_synced = false;
+    return written && read;
+}
+
+bool SimDaq::transfer_all(const std::vector<CycleStep>& steps) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    wait_latency();
+    m_synced = true;
+    bool success = Daq::transfer_all(steps);
+    m_synced = false;
+    return success;
+}
+
+void SimDaq::set_latency(const SimLatency& latency) {
+    std::lock_guard<std::recursive_mutex> lock(m_mutex);
+    m_latency = latency;
+}
+
+const SimLatency& SimDaq::latency() const {
+    return m_latency;
+}
+
+std::uint64_t SimDaq::transactions() const {
+    return m_transactions;
+}
+
+SimDaq::Transaction SimDaq::transact() {
+    Transaction transaction(m_mutex);
+    if (!m_synced)
+        wait_latency();
+    return transaction;
+}
+
+void SimDaq::wait_latency() {
+    m_transactions.fetch_add(1, std::memory_order_relaxed);
+    if (m_latency.mean_us <= 0 && m_latency.jitter_us <= 0)
+        return;
+    double us = m_latency.mean_us + m_latency.jitter_us * m_jitter(m_rng);
+    if (us <= 0)
+        return;
+    auto until = std::chrono::steady_clock::now() +
+                 std::chrono::nanoseconds(static_cast<std::int64_t>(us * 1000));
+    if (m_latency.blocking)
+        std::this_thread::sleep_until(until);
+    else
+        while (std::chrono::steady_clock::now() < until) {}
+}
+
+} // namespace daq
+} // namespace mahi
@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+#include <Mahi/Daq/Trace.hpp>
+#include <Mahi/Daq/Buffer.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+#include <cstring>
+
+using namespace mahi::util;
+
+namespace mahi {
+namespace daq {
+
+namespace {
+
+const char TraceMagic[8] = {'M', 'A', 'H', 'I', 'T', 'R', 'C', '1'};
+
+/// Writes a trivially copyable value
+template <typename T>
+void put(std::FILE* file, const T& value) {
+    std::fwrite(&value, sizeof(T), 1, file);
+}
+
+/// Sequentially reads trivially copyable values from a byte range
+class Cursor {
+public:
+    Cursor(const char* begin, const char* end) : m_pos(begin), m_end(end) {}
+    template <typename T>
+    bool get(T& value) { return get(&value, sizeof(T)); }
+    bool get(void* dst, std::size_t size) {
+        if (static_cast<std::size_t>(m_end - m_pos) < size)
+            return false;
+        if (size)
+            std::memcpy(dst, m_pos, size);
+        m_pos += size;
+        return true;
+    }
+    bool skip(std::size_t size) {
+        if (static_cast<std::size_t>(m_end - m_pos) < size)
+            return false;
+        m_pos += size;
+        return true;
+    }
+    bool done() const { return m_pos == m_end; }
+private:
+    const char* m_pos;
+    const char* m_end;
+};
+
+}  // namespace
+
+//==============================================================================
+// TRACE WRITER
+//==============================================================================
+
+TraceWriter::TraceWriter(std::size_t buffer_size) :
+    m_buffer(buffer_size),
+    m_file(nullptr),
+    m_daq(nullptr),
+    m_records(0)
+{ }
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+bool TraceWriter::open(Daq& daq, const std::string& filename) {
+    if (is_open()) {
+        LOG(Error) << "Cannot open trace " << filename << " because TraceWriter is already open.";
+        return false;
+    }
+    m_file = std::fopen(filename.c_str(), "wb");
+    if (!m_file) {
+        LOG(Error) << "Failed to open trace " << filename << " for writing.";
+        return false;
+    }
+    if (!m_buffer.empty())
+        std::setvbuf(m_file, &m_buffer[0], _IOFBF, m_buffer.size());
+    m_daq     = &daq;
+    m_records = 0;
+    m_streams.clear();
+    for (auto& r : daq.m_readables)
+        r->trace_read(this);
+    for (auto& w : daq.m_writeables)
+        w->trace_write(this);
+    std::fwrite(TraceMagic, 1, sizeof(TraceMagic), m_file);
+    put(m_file, static_cast<std::uint32_t>(m_streams.size()));
+    for (auto& s : m_streams) {
+        put(m_file, static_cast<std::uint32_t>(s.module.size()));
+        std::fwrite(s.module.data(), 1, s.module.size(), m_file);
+        put(m_file, static_cast<std::uint8_t>(s.output));
+        put(m_file, static_cast<std::uint8_t>(s.type));
+        put(m_file, static_cast<std::uint16_t>(s.size));
+        put(m_file, static_cast<std::uint32_t>(s.channels.size()));
+        for (auto& ch : s.channels)
+            put(m_file, static_cast<std::uint32_t>(ch));
+        for (auto& ch : s.internal)
+            put(m_file, static_cast<std::uint32_t>(ch));
+    }
+    m_start = std::chrono::steady_clock::now();
+    LOG(Verbose) << "Opened trace " << filename << " of " << daq.name() << " with " << m_streams.size() << " streams.";
+    return true;
+}
+
+void TraceWriter::close() {
+    if (!is_open())
+        return;
+    for (auto& r : m_daq->m_readables)
+        r->trace_read(nullptr);
+    for (auto& w : m_daq->m_writeables)
+        w->trace_write(nullptr);
+    std::fclose(m_file);
+    m_file = nullptr;
+    m_daq  = nullptr;
+}
+
+bool TraceWriter::is_open() const {
+    return m_file != nullptr;
+}
+
+std::uint64_t TraceWriter::records() const {
+    return m_records;
+}
+
+const std::vector<TraceStream>& TraceWriter::streams() const {
+    return m_streams;
+}
+
+std::uint32_t TraceWriter::add_stream(const ChanneledModule& module, bool output, TraceType type, std::size_t size) {
+    TraceStream s;
+    s.module   = module.name();
+    s.output   = output;
+    s.type     = type;
+    s.size     = size;
+    s.channels = module.channels();
+    s.internal = module.channels_internal();
+    m_streams.push_back(s);
+    return static_cast<std::uint32_t>(m_streams.size() - 1);
+}
+
+void TraceWriter::log(std::uint32_t stream, const ChanNum* chs, const void* values, std::size_t n) {
+    if (!m_file)
+        return;
+    std::int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+    put(m_file, stream);
+    put(m_file, static_cast<std::uint32_t>(n));
+    put(m_file, t);
+    std::fwrite(chs, sizeof(ChanNum), n, m_file);
+    std::fwrite(values, m_streams[stream].size, n, m_file);
+    ++m_records;
+}
+
+//==============================================================================
+// TRACE READER
+//==============================================================================
+
+bool TraceReader::load(const std::string& filename) {
+    static_assert(sizeof(ChanNum) == sizeof(std::uint32_t), "traces store channel numbers as uint32");
+    m_streams.clear();
+    m_records.clear();
+    m_channels.clear();
+    m_values.clear();
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        LOG(Error) << "Failed to open trace " << filename << " for reading.";
+        return false;
+    }
+    std::vector<char> data;
+    char chunk[1 << 16];
+    std::size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + got);
+    std::fclose(file);
+    const char* begin = data.empty() ? nullptr : &data[0];
+    Cursor cur(begin, begin + data.size());
+    // header
+    char magic[8];
+    std::uint32_t count;
+    if (!cur.get(magic, sizeof(magic)) || std::memcmp(magic, TraceMagic, sizeof(magic)) != 0 || !cur.get(count)) {
+        LOG(Error) << filename << " is not a mahi::daq trace.";
+        return false;
+    }
+    for (std::uint32_t i = 0; i < count; ++i) {
+        TraceStream   s;
+        std::uint32_t len, chs;
+        std::uint8_t  output, type;
+        std::uint16_t size;
+        bool ok = cur.get(len);
+        s.module.resize(ok ? len : 0);
+        ok = ok && (len == 0 || cur.get(&s.module[0], len)) && cur.get(output) && cur.get(type) &&
+             cur.get(size) && cur.get(chs) && size > 0 && size <= sizeof(std::uint64_t);
+        s.channels.resize(ok ? chs : 0);
+        s.internal.resize(ok ? chs : 0);
+        ok = ok && (chs == 0 || (cur.get(&s.channels[0], chs * sizeof(ChanNum)) &&
+                                 cur.get(&s.internal[0], chs * sizeof(ChanNum))));
+        if (!ok) {
+            LOG(Error) << "Trace " << filename << " has a corrupt header.";
+            return false;
+        }
+        s.output = output != 0;
+        s.type   = static_cast<TraceType>(type);
+        s.size   = size;
+        m_streams.push_back(s);
+    }
+    m_records.resize(m_streams.size());
+    // records, in two passes so that pointers into the pools stay valid
+    Cursor body = cur;
+    std::size_t total_chs = 0, total_words = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        cur = body;
+        while (!cur.done()) {
+            std::uint32_t stream, n;
+            std::int64_t  t;
+            if (!cur.get(stream) || !cur.get(n) || !cur.get(t) || stream >= m_streams.size()) {
+                LOG(Warning) << "Trace " << filename << " ends with a truncated record.";
+                break;
+            }
+            std::size_t bytes = n * m_streams[stream].size;
+            std::size_t words = (bytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+            if (pass == 0) {
+                if (!cur.skip(n * sizeof(ChanNum) + bytes)) {
+                    LOG(Warning) << "Trace " << filename << " ends with a truncated record.";
+                    break;
+                }
+                total_chs += n;
+                total_words += words;
+            }
+            else {
+                if (m_channels.size() + n > total_chs)
+                    break;
+                Record rec;
+                rec.n       = n;
+                rec.time_ns = t;
+                std::size_t c = m_channels.size(), v = m_values.size();
+                m_channels.resize(c + n);
+                m_values.resize(v + words);
+                cur.get(n ? &m_channels[c] : nullptr, n * sizeof(ChanNum));
+                cur.get(words ? &m_values[v] : nullptr, bytes);
+                rec.channels = n ? &m_channels[c] : nullptr;
+                rec.values   = words ? &m_values[v] : nullptr;
+                m_records[stream].push_back(rec);
+            }
+        }
+        if (pass == 0) {
+            m_channels.reserve(total_chs);
+            m_values.reserve(total_words);
+        }
+    }
+    return true;
+}
+
+}  // namespace daq
+}  // namespace mahi
@@ -43,5 +43,31 @@ void print_info(const Daq& daq) {
     }
 }
 
+namespace {
+void print_stats(const std::string& label, const LatencyHistogram& h) {
+    auto s = h.stats();
+    fmt::print("{:<24} {:>10} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}\n", label, s.count,
+               s.p50_ns / 1000.0, s.p99_ns / 1000.0, s.p999_ns / 1000.0, s.max_ns / 1000.0);
+}
+} // private namespace
+
+void print_latency(const Daq& daq) {
+#ifndef MAHI_DAQ_METRICS
+    fmt::print("Latency metrics are disabled (build with MAHI_DAQ_METRICS)\n");
+    return;
+#endif
+    fmt::print("{:<24} {:>10} {:>10} {:>10} {:>10} {:>10}\n", "[us]", "count", "p50", "p99", "p99.9", "max");
+    print_stats(daq.name() + ".read_all", daq.read_all_latency());
+    print_stats(daq.name() + ".write_all", daq.write_all_latency());
+    for (auto& m : daq.modules()) {
+        if (auto cm = dynamic_cast<const ChanneledModule*>(m)) {
+            if (cm->read_latency().count() > 0)
+                print_stats(cm->name() + ".read", cm->read_latency());
+            if (cm->write_latency().count() > 0)
+                print_stats(cm->name() + ".write", cm->write_latency());
+        }
+    }
+}
+
 } // namespace daq
 } // namespace mahi
\ No newline at end of file
@@ -1,4 +1,7 @@
 #include <Mahi/Daq/Watchdog.hpp>
+#include <Mahi/Util/Logging/Log.hpp>
+
+using namespace mahi::util;
 
 namespace mahi {
 namespace daq {
@@ -7,10 +10,17 @@ namespace daq {
 // CLASS DEFINTIONS
 //===============================================================================
 
+constexpr double Watchdog::MaxKickFraction;
+
 Watchdog::Watchdog(Daq& daq) :
     Module(daq),
     m_timout(util::Time::Inf),
-    m_watching(false)
+    m_watching(false),
+    m_kick_fraction(0.5),
+    m_check_interval(-1),
+    m_kicked(false),
+    m_kicks(0),
+    m_kicks_skipped(0)
 { }
 
 Watchdog::~Watchdog() { }
@@ -23,6 +33,52 @@ util::Time Watchdog::timeout() const {
     return m_timout;
 }
 
+bool Watchdog::kick_if_due(bool cycle_ok) {
+    auto now = Steady::now();
+    Micros check = m_check_interval.count() >= 0 ? m_check_interval
+                 : Micros(0.5 * static_cast<double>(m_timout.as_microseconds()));
+    if (now - m_last_check >= check) {
+        m_last_check = now;
+        if (is_expired())
+            return false;
+    }
+    // a cycle that failed its writes must not keep the outputs alive
+    if (!cycle_ok)
+        return true;
+    Micros due(m_kick_fraction * static_cast<double>(m_timout.as_microseconds()));
+    if (m_kicked && now - m_last_kick < due) {
+        m_kicks_skipped++;
+        return true;
+    }
+    if (!kick()) {
+        m_kicked = false;
+        return false;
+    }
+    m_kicks++;
+    m_kicked    = true;
+    m_last_kick = now;
+    return true;
+}
+
+void Watchdog::set_kick_fraction(double fraction) {
+    // kicks only happen on cycle boundaries, so kicking any later would let it expire
+    if (fraction > MaxKickFraction)
+        LOG(Warning) << "Watchdog kick fraction " << fraction << " clamped to " << MaxKickFraction << ".";
+    m_kick_fraction = fraction < 0 ? 0 : fraction > MaxKickFraction ? MaxKickFraction : fraction;
+}
+
+void Watchdog::set_expiry_check_interval(util::Time interval) {
+    m_check_interval = Micros(static_cast<double>(interval.as_microseconds()));
+}
+
+std::uint64_t Watchdog::kicks() const {
+    return m_kicks;
+}
+
+std::uint64_t Watchdog::kicks_skipped() const {
+    return m_kicks_skipped;
+}
+
 
 } // namespace daq
 } // namespace mahi